@@ -0,0 +1,68 @@
+# Writes every SPIR-V file of SHADER_DIR into OUTPUT as constexpr uint32_t
+# arrays, plus the table findEmbeddedShader() looks names up in.
+#
+#   cmake -DSHADER_DIR=<dir> -DOUTPUT=<file.cc> -P embed_shaders.cmake
+
+file(GLOB SPIRV_FILES "${SHADER_DIR}/*.spv")
+list(SORT SPIRV_FILES)
+
+set(ARRAYS "")
+set(TABLE "")
+
+foreach(SPIRV_FILE ${SPIRV_FILES})
+  get_filename_component(SHADER_NAME ${SPIRV_FILE} NAME)
+  string(MAKE_C_IDENTIFIER ${SHADER_NAME} SHADER_IDENTIFIER)
+
+  file(READ ${SPIRV_FILE} SPIRV_HEX HEX)
+  string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+  math(EXPR SPIRV_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+
+  if(SPIRV_HEX_LENGTH EQUAL 0 OR NOT SPIRV_REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${SPIRV_FILE} is not a whole number of SPIR-V words.")
+  endif()
+
+  # SPIR-V is little endian, swap each group of four bytes into a word.
+  string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " SPIRV_WORDS "${SPIRV_HEX}")
+  string(REPEAT "0x........, " 8 SPIRV_LINE)
+  string(REGEX REPLACE "(${SPIRV_LINE})" "\\1\n  " SPIRV_WORDS "${SPIRV_WORDS}")
+  string(REGEX REPLACE "[ \n]+$" "" SPIRV_WORDS "${SPIRV_WORDS}")
+
+  string(APPEND ARRAYS "alignas(4) constexpr uint32_t ${SHADER_IDENTIFIER}[] = {\n  ${SPIRV_WORDS}\n};\n\n")
+  string(APPEND TABLE "  {\"${SHADER_NAME}\", ${SHADER_IDENTIFIER}, sizeof(${SHADER_IDENTIFIER})},\n")
+endforeach()
+
+set(CONTENT "// Generated by cmake/embed_shaders.cmake, do not edit.
+
+#include \"render/vulkan/embedded_shaders.h\"
+
+namespace benpu {
+
+namespace {
+
+${ARRAYS}constexpr EmbeddedShader embeddedShaders[] = {
+${TABLE}};
+
+} //namespace
+
+const EmbeddedShader* findEmbeddedShader(std::string_view name) {
+
+  for (const EmbeddedShader& shader : embeddedShaders) {
+    if (name == shader.name) {
+      return &shader;
+    }
+  }
+
+  return nullptr;
+}
+
+} //namespace benpu
+")
+
+# Keep the timestamp when nothing changed, so the library isn't rebuilt.
+if(EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} PREVIOUS_CONTENT)
+endif()
+
+if(NOT "${CONTENT}" STREQUAL "${PREVIOUS_CONTENT}")
+  file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
@@ -23,6 +23,15 @@ ConfigurationManager& ConfigurationManager::getInstance(Args* args) {
 
 ConfigurationManager::ConfigurationManager(Args& args) {
 
+  loadConfiguration(args);
+
+  if (args.values.count(ArgType::headless) > 0) {
+    configuration["headless"] = true;
+  }
+}
+
+void ConfigurationManager::loadConfiguration(Args& args) {
+
   std::filesystem::path configurationFilePath = std::filesystem::path(args.values[ArgType::configurationFile]);
 
   bool writeConfigurationFile = false;
@@ -55,7 +64,28 @@ ConfigurationManager::ConfigurationManager(Args& args) {
   "screenSize": {
     "x": 800,
     "y": 600
-  }
+  },
+  "framesInFlight": 2,
+  "presentPolicy": "mailbox",
+  "headless": false,
+  "headlessSurface": false,
+  "frameCount": 0,
+  "targetFrameRate": 0,
+  "dynamicRendering": true,
+  "recordingThreads": 0,
+  "staticCommands": true,
+  "asyncCompute": true,
+  "stagingRingSize": 33554432,
+  "memoryBlockSize": 67108864,
+  "geometryVertexCapacity": 1048576,
+  "geometryIndexCapacity": 3145728,
+  "bindlessStorageBuffers": 8192,
+  "bindlessSamplers": 256,
+  "bindlessSampledImages": 16384,
+  "descriptorSetsPerPool": 128,
+  "uniformRingFrameSize": 4194304,
+  "pipelineCacheSaveInterval": 60,
+  "pipelineCompileThreads": 0
 }
   )");
 
@@ -18,17 +18,37 @@ public:
 
   nlohmann::json operator[](std::string a);
 
+  template <typename T>
+  T get(const std::string& key, const T& defaultValue) const;
+
 private:
   nlohmann::json configuration;
 
   ConfigurationManager(Args& args);
 
+  void loadConfiguration(Args& args);
+
   ~ConfigurationManager() {}
 
   ConfigurationManager(const ConfigurationManager&) = delete;
   ConfigurationManager& operator=(const ConfigurationManager&) = delete;
 };
 
+template <typename T>
+T ConfigurationManager::get(const std::string& key, const T& defaultValue) const {
+  auto value = configuration.find(key);
+
+  if (value == configuration.end() || value->is_null()) {
+    return defaultValue;
+  }
+
+  try {
+    return value->get<T>();
+  } catch (const nlohmann::json::exception& e) {
+    return defaultValue;
+  }
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -24,6 +24,9 @@ Args::Args(int argc, char* argv[]) {
       argv++;
       values[ArgType::configurationFile] = std::string(argv[0]);
       break;
+    case 'H':
+      values[ArgType::headless] = "true";
+      break;
     default:
       areArgumentsCorrect = false;
       return;
@@ -7,7 +7,8 @@
 namespace benpu {
 
 enum ArgType {
-  configurationFile
+  configurationFile,
+  headless
 };
 
 class Args {
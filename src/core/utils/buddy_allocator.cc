@@ -0,0 +1,97 @@
+#include <algorithm>
+
+#include "core/utils/buddy_allocator.h"
+
+namespace benpu {
+
+BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t minBlockSize): minBlockSize{minBlockSize}, maxOrder{0} {
+
+  while (getBlockSize(maxOrder + 1) <= size) {
+    ++maxOrder;
+  }
+
+  this->size = getBlockSize(maxOrder);
+
+  freeBlocks.resize(maxOrder + 1);
+  freeBlocks[maxOrder].insert(0);
+}
+
+std::optional<uint64_t> BuddyAllocator::allocate(uint64_t size, uint64_t alignment) {
+
+  uint64_t needed = std::max({size, alignment, minBlockSize});
+
+  if (size == 0 || needed > this->size) {
+    return std::nullopt;
+  }
+
+  uint32_t order = 0;
+  while (getBlockSize(order) < needed) {
+    ++order;
+  }
+
+  uint32_t available = order;
+  while (available <= maxOrder && freeBlocks[available].empty()) {
+    ++available;
+  }
+
+  if (available > maxOrder) {
+    return std::nullopt;
+  }
+
+  uint64_t offset = *freeBlocks[available].begin();
+  freeBlocks[available].erase(freeBlocks[available].begin());
+
+  // Split down to the requested order, the upper halves become free buddies.
+  while (available > order) {
+    --available;
+    freeBlocks[available].insert(offset + getBlockSize(available));
+  }
+
+  allocations[offset] = {order, size};
+  allocatedBytes += getBlockSize(order);
+  requestedBytes += size;
+
+  return offset;
+}
+
+void BuddyAllocator::free(uint64_t offset) {
+
+  auto found = allocations.find(offset);
+
+  if (found == allocations.end()) {
+    return;
+  }
+
+  uint32_t order = found->second.order;
+  allocatedBytes -= getBlockSize(order);
+  requestedBytes -= found->second.size;
+  allocations.erase(found);
+
+  while (order < maxOrder) {
+    uint64_t buddy = offset ^ getBlockSize(order);
+    auto freeBuddy = freeBlocks[order].find(buddy);
+
+    if (freeBuddy == freeBlocks[order].end()) {
+      break;
+    }
+
+    freeBlocks[order].erase(freeBuddy);
+    offset = std::min(offset, buddy);
+    ++order;
+  }
+
+  freeBlocks[order].insert(offset);
+}
+
+uint64_t BuddyAllocator::getLargestFreeBlock() const {
+
+  for (uint32_t order = maxOrder + 1; order-- > 0;) {
+    if (!freeBlocks[order].empty()) {
+      return getBlockSize(order);
+    }
+  }
+
+  return 0;
+}
+
+} //namespace benpu
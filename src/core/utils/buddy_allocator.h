@@ -0,0 +1,50 @@
+#ifndef BENPU_BUDDY_ALLOCATOR_H_
+#define BENPU_BUDDY_ALLOCATOR_H_
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace benpu {
+
+// Binary buddy placement over a range of power of two size. Blocks are
+// aligned to their own size, so any alignment up to the block size comes
+// for free, and freed blocks merge back with their buddy in O(log n).
+class BuddyAllocator {
+public:
+  BuddyAllocator(uint64_t size, uint64_t minBlockSize);
+
+  std::optional<uint64_t> allocate(uint64_t size, uint64_t alignment);
+  void free(uint64_t offset);
+
+  uint64_t getSize() const { return size; }
+  uint64_t getAllocatedBytes() const { return allocatedBytes; }
+  uint64_t getRequestedBytes() const { return requestedBytes; }
+  uint64_t getLargestFreeBlock() const;
+  size_t getAllocationCount() const { return allocations.size(); }
+  bool isEmpty() const { return allocations.empty(); }
+
+private:
+  struct Allocation {
+    uint32_t order;
+    uint64_t size;
+  };
+
+  uint64_t size;
+  uint64_t minBlockSize;
+  uint32_t maxOrder;
+  // Free block offsets per order, order k blocks are minBlockSize << k.
+  std::vector<std::set<uint64_t>> freeBlocks;
+  std::unordered_map<uint64_t, Allocation> allocations;
+  uint64_t allocatedBytes = 0;
+  uint64_t requestedBytes = 0;
+
+private:
+  uint64_t getBlockSize(uint32_t order) const { return minBlockSize << order; }
+};
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <thread>
+
+#include "core/utils/frame_pacer.h"
+
+namespace benpu {
+
+static constexpr std::chrono::microseconds minSpinThreshold{200};
+static constexpr std::chrono::microseconds maxSpinThreshold{4000};
+
+FramePacer::FramePacer(double targetFrameRate): spinThreshold{std::chrono::microseconds(1000)} {
+  if (targetFrameRate > 0.0) {
+    targetFrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFrameRate));
+  }
+}
+
+void FramePacer::wait() {
+
+  if (!isEnabled()) {
+    return;
+  }
+
+  Clock::time_point now = Clock::now();
+
+  if (!started) {
+    deadline = now;
+    started = true;
+  }
+
+  // More than a whole frame late, catching up would only produce a burst
+  // of unpaced frames.
+  if (now > deadline + targetFrameTime) {
+    deadline = now;
+  }
+
+  if (deadline - now > spinThreshold) {
+    Clock::time_point wakeUp = deadline - spinThreshold;
+    std::this_thread::sleep_until(wakeUp);
+
+    // The spin stretch follows how late the scheduler wakes us up.
+    Clock::duration oversleep = Clock::now() - wakeUp;
+    spinThreshold = std::clamp<Clock::duration>(
+      (spinThreshold * 7 + oversleep * 2) / 8,
+      minSpinThreshold,
+      maxSpinThreshold
+    );
+  }
+
+  while (Clock::now() < deadline) {
+  }
+
+  deadline += targetFrameTime;
+}
+
+} //namespace benpu
@@ -0,0 +1,30 @@
+#ifndef BENPU_FRAME_PACER_H_
+#define BENPU_FRAME_PACER_H_
+
+#include <chrono>
+
+namespace benpu {
+
+// Holds frames to a fixed period on the monotonic clock. Deadlines are
+// absolute, so the error of one frame doesn't accumulate into the next.
+class FramePacer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  FramePacer(double targetFrameRate);
+
+  void wait();
+
+  bool isEnabled() const { return targetFrameTime.count() > 0; }
+  Clock::duration getTargetFrameTime() const { return targetFrameTime; }
+
+private:
+  Clock::duration targetFrameTime{0};
+  Clock::duration spinThreshold;
+  Clock::time_point deadline;
+  bool started = false;
+};
+
+} //namespace benpu
+
+#endif
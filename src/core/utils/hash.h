@@ -0,0 +1,17 @@
+#ifndef BENPU_HASH_H_
+#define BENPU_HASH_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace benpu {
+
+// Mixes the hash of value into seed, order dependent.
+template <typename T>
+inline void hashCombine(size_t& seed, const T& value) {
+  seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,54 @@
+#include "core/utils/ring_allocator.h"
+
+namespace benpu {
+
+RingAllocator::RingAllocator(uint64_t capacity): capacity{capacity} {
+
+}
+
+std::optional<uint64_t> RingAllocator::allocate(uint64_t size, uint64_t alignment) {
+
+  if (size == 0 || size > capacity) {
+    return std::nullopt;
+  }
+
+  alignment = alignment == 0 ? 1 : alignment;
+
+  uint64_t head = allocatedBytes % capacity;
+  uint64_t offset = (head + alignment - 1) / alignment * alignment;
+  uint64_t padding = offset - head;
+
+  // Allocations never straddle the end, the rest of the ring is skipped.
+  if (offset + size > capacity) {
+    offset = 0;
+    padding = capacity - head;
+  }
+
+  if (getUsed() + padding + size > capacity) {
+    return std::nullopt;
+  }
+
+  allocatedBytes += padding + size;
+
+  return offset;
+}
+
+void RingAllocator::retire(uint64_t value) {
+
+  if (!hasUnretiredAllocations()) {
+    return;
+  }
+
+  fences.push_back({value, allocatedBytes});
+  retiredBytes = allocatedBytes;
+}
+
+void RingAllocator::reclaim(uint64_t completedValue) {
+
+  while (!fences.empty() && fences.front().value <= completedValue) {
+    freedBytes = fences.front().allocatedBytes;
+    fences.pop_front();
+  }
+}
+
+} //namespace benpu
@@ -0,0 +1,43 @@
+#ifndef BENPU_RING_ALLOCATOR_H_
+#define BENPU_RING_ALLOCATOR_H_
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace benpu {
+
+// Offset bookkeeping of a ring buffer whose space is given back in the
+// order it was handed out. Allocations are grouped by retire(value) and
+// reclaimed together once that value (e.g. a timeline semaphore value)
+// has completed.
+class RingAllocator {
+public:
+  RingAllocator(uint64_t capacity = 0);
+
+  std::optional<uint64_t> allocate(uint64_t size, uint64_t alignment);
+  void retire(uint64_t value);
+  void reclaim(uint64_t completedValue);
+
+  uint64_t getCapacity() const { return capacity; }
+  uint64_t getUsed() const { return allocatedBytes - freedBytes; }
+  bool hasUnretiredAllocations() const { return allocatedBytes != retiredBytes; }
+
+private:
+  struct Fence {
+    uint64_t value;
+    uint64_t allocatedBytes;
+  };
+
+  uint64_t capacity;
+  // Running totals, wrap padding included, so the head and tail offsets are
+  // simply the totals modulo the capacity.
+  uint64_t allocatedBytes = 0;
+  uint64_t retiredBytes = 0;
+  uint64_t freedBytes = 0;
+  std::deque<Fence> fences;
+};
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <unordered_map>
+
+#include "core/utils/spirv_reflection.h"
+
+namespace benpu {
+
+namespace {
+
+// The few values of the SPIR-V grammar the reflection looks at.
+constexpr uint32_t magicNumber = 0x07230203;
+
+constexpr uint32_t opEntryPoint = 15;
+constexpr uint32_t opTypeBool = 20;
+constexpr uint32_t opTypeInt = 21;
+constexpr uint32_t opTypeFloat = 22;
+constexpr uint32_t opTypeVector = 23;
+constexpr uint32_t opTypeMatrix = 24;
+constexpr uint32_t opTypeImage = 25;
+constexpr uint32_t opTypeSampler = 26;
+constexpr uint32_t opTypeSampledImage = 27;
+constexpr uint32_t opTypeArray = 28;
+constexpr uint32_t opTypeRuntimeArray = 29;
+constexpr uint32_t opTypeStruct = 30;
+constexpr uint32_t opTypePointer = 32;
+constexpr uint32_t opConstant = 43;
+constexpr uint32_t opVariable = 59;
+constexpr uint32_t opDecorate = 71;
+constexpr uint32_t opMemberDecorate = 72;
+
+constexpr uint32_t decorationSpecId = 1;
+constexpr uint32_t decorationBufferBlock = 3;
+constexpr uint32_t decorationArrayStride = 6;
+constexpr uint32_t decorationMatrixStride = 7;
+constexpr uint32_t decorationBuiltIn = 11;
+constexpr uint32_t decorationLocation = 30;
+constexpr uint32_t decorationBinding = 33;
+constexpr uint32_t decorationDescriptorSet = 34;
+constexpr uint32_t decorationOffset = 35;
+
+constexpr uint32_t storageUniformConstant = 0;
+constexpr uint32_t storageInput = 1;
+constexpr uint32_t storageUniform = 2;
+constexpr uint32_t storagePushConstant = 9;
+constexpr uint32_t storageStorageBuffer = 12;
+
+constexpr uint32_t executionModelVertex = 0;
+constexpr uint32_t executionModelFragment = 4;
+constexpr uint32_t executionModelGLCompute = 5;
+
+constexpr uint32_t dimBuffer = 5;
+
+using Decorations = std::unordered_map<uint32_t, uint32_t>;
+
+struct Type {
+  uint32_t opcode;
+  // Operands after the result id.
+  std::vector<uint32_t> operands;
+};
+
+struct Variable {
+  uint32_t id;
+  uint32_t pointerType;
+  uint32_t storageClass;
+};
+
+struct Module {
+  std::unordered_map<uint32_t, Type> types;
+  std::unordered_map<uint32_t, uint32_t> constants;
+  std::unordered_map<uint32_t, Decorations> decorations;
+  std::unordered_map<uint32_t, std::vector<Decorations>> memberDecorations;
+  std::vector<Variable> variables;
+
+  const Type* getType(uint32_t id) const {
+    auto found = types.find(id);
+    return found != types.end() ? &found->second : nullptr;
+  }
+
+  std::optional<uint32_t> getDecoration(uint32_t id, uint32_t decoration) const {
+    auto found = decorations.find(id);
+
+    if (found == decorations.end()) {
+      return std::nullopt;
+    }
+
+    auto value = found->second.find(decoration);
+
+    if (value == found->second.end()) {
+      return std::nullopt;
+    }
+
+    return value->second;
+  }
+
+  std::optional<uint32_t> getMemberDecoration(uint32_t id, uint32_t member, uint32_t decoration) const {
+    auto found = memberDecorations.find(id);
+
+    if (found == memberDecorations.end() || member >= found->second.size()) {
+      return std::nullopt;
+    }
+
+    auto value = found->second[member].find(decoration);
+
+    if (value == found->second[member].end()) {
+      return std::nullopt;
+    }
+
+    return value->second;
+  }
+
+  // Size in bytes as laid out by the Offset, ArrayStride and MatrixStride
+  // decorations, which every block has.
+  uint32_t getSize(uint32_t id, uint32_t matrixStride = 0) const {
+    const Type* type = getType(id);
+
+    if (!type) {
+      return 0;
+    }
+
+    switch (type->opcode) {
+      case opTypeBool:
+        return 4;
+      case opTypeInt:
+      case opTypeFloat:
+        return type->operands[0] / 8;
+      case opTypeVector:
+        return type->operands[1] * getSize(type->operands[0]);
+      case opTypeMatrix:
+        return type->operands[1] * (matrixStride ? matrixStride : getSize(type->operands[0]));
+      case opTypeArray: {
+        auto length = constants.find(type->operands[1]);
+        uint32_t stride = getDecoration(id, decorationArrayStride).value_or(getSize(type->operands[0], matrixStride));
+        return length != constants.end() ? length->second * stride : 0;
+      }
+      case opTypeStruct: {
+        uint32_t size = 0;
+
+        for (uint32_t member = 0; member < type->operands.size(); ++member) {
+          uint32_t offset = getMemberDecoration(id, member, decorationOffset).value_or(size);
+          uint32_t stride = getMemberDecoration(id, member, decorationMatrixStride).value_or(0);
+          size = std::max(size, offset + getSize(type->operands[member], stride));
+        }
+
+        return size;
+      }
+      default:
+        return 0;
+    }
+  }
+};
+
+std::optional<SpirvReflection::DescriptorKind> getDescriptorKind(const Module& module, uint32_t storageClass, uint32_t typeId) {
+
+  const Type* type = module.getType(typeId);
+
+  if (!type) {
+    return std::nullopt;
+  }
+
+  if (storageClass == storageStorageBuffer) {
+    return SpirvReflection::DescriptorKind::storageBuffer;
+  }
+
+  if (storageClass == storageUniform) {
+    //Storage buffers were Uniform blocks decorated BufferBlock before SPIR-V 1.3.
+    if (module.getDecoration(typeId, decorationBufferBlock)) {
+      return SpirvReflection::DescriptorKind::storageBuffer;
+    }
+    return SpirvReflection::DescriptorKind::uniformBuffer;
+  }
+
+  if (storageClass != storageUniformConstant) {
+    return std::nullopt;
+  }
+
+  switch (type->opcode) {
+    case opTypeSampler:
+      return SpirvReflection::DescriptorKind::sampler;
+    case opTypeSampledImage:
+      return SpirvReflection::DescriptorKind::combinedImageSampler;
+    case opTypeImage: {
+      bool buffer = type->operands[1] == dimBuffer;
+      bool storage = type->operands[5] == 2;
+
+      if (buffer) {
+        return storage ? SpirvReflection::DescriptorKind::storageTexelBuffer : SpirvReflection::DescriptorKind::uniformTexelBuffer;
+      }
+      return storage ? SpirvReflection::DescriptorKind::storageImage : SpirvReflection::DescriptorKind::sampledImage;
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+bool isValidType(uint32_t opcode, size_t operandCount) {
+  switch (opcode) {
+    case opTypeInt:
+    case opTypeVector:
+    case opTypeMatrix:
+    case opTypeArray:
+      return operandCount >= 2;
+    case opTypeFloat:
+    case opTypeRuntimeArray:
+      return operandCount >= 1;
+    case opTypeImage:
+      return operandCount >= 7;
+    case opTypePointer:
+      return operandCount >= 2;
+    default:
+      return true;
+  }
+}
+
+} //namespace
+
+std::optional<SpirvReflection> reflectSpirv(const uint32_t* code, size_t wordCount) {
+
+  if (!code || wordCount < 5 || code[0] != magicNumber) {
+    return std::nullopt;
+  }
+
+  SpirvReflection reflection;
+  Module module;
+  std::vector<uint32_t> specializationIds;
+  bool entryPointFound = false;
+
+  for (size_t offset = 5; offset < wordCount;) {
+    uint32_t instructionWords = code[offset] >> 16;
+    uint32_t opcode = code[offset] & 0xffff;
+
+    if (instructionWords == 0 || offset + instructionWords > wordCount) {
+      return std::nullopt;
+    }
+
+    const uint32_t* operands = code + offset + 1;
+    size_t operandCount = instructionWords - 1;
+
+    switch (opcode) {
+      case opEntryPoint:
+        //Modules with several entry points are reflected as the first one.
+        if (!entryPointFound && operandCount >= 1) {
+          entryPointFound = true;
+          switch (operands[0]) {
+            case executionModelVertex: reflection.stage = SpirvReflection::Stage::vertex; break;
+            case executionModelFragment: reflection.stage = SpirvReflection::Stage::fragment; break;
+            case executionModelGLCompute: reflection.stage = SpirvReflection::Stage::compute; break;
+            default: reflection.stage = SpirvReflection::Stage::other; break;
+          }
+        }
+        break;
+      case opTypeBool:
+      case opTypeInt:
+      case opTypeFloat:
+      case opTypeVector:
+      case opTypeMatrix:
+      case opTypeImage:
+      case opTypeSampler:
+      case opTypeSampledImage:
+      case opTypeArray:
+      case opTypeRuntimeArray:
+      case opTypeStruct:
+      case opTypePointer:
+        if (operandCount < 1 || !isValidType(opcode, operandCount - 1)) {
+          return std::nullopt;
+        }
+        module.types[operands[0]] = {opcode, std::vector<uint32_t>(operands + 1, operands + operandCount)};
+        break;
+      case opConstant:
+        //Only the low word matters, constants are read as array lengths.
+        if (operandCount >= 3) {
+          module.constants[operands[1]] = operands[2];
+        }
+        break;
+      case opVariable:
+        if (operandCount < 3) {
+          return std::nullopt;
+        }
+        module.variables.push_back({operands[1], operands[0], operands[2]});
+        break;
+      case opDecorate:
+        if (operandCount < 2) {
+          return std::nullopt;
+        }
+        module.decorations[operands[0]][operands[1]] = operandCount >= 3 ? operands[2] : 0;
+        if (operands[1] == decorationSpecId && operandCount >= 3) {
+          specializationIds.push_back(operands[2]);
+        }
+        break;
+      case opMemberDecorate: {
+        if (operandCount < 3) {
+          return std::nullopt;
+        }
+        std::vector<Decorations>& members = module.memberDecorations[operands[0]];
+        if (members.size() <= operands[1]) {
+          members.resize(operands[1] + 1);
+        }
+        members[operands[1]][operands[2]] = operandCount >= 4 ? operands[3] : 0;
+        break;
+      }
+      default:
+        break;
+    }
+
+    offset += instructionWords;
+  }
+
+  if (!entryPointFound) {
+    return std::nullopt;
+  }
+
+  for (const Variable& variable : module.variables) {
+    const Type* pointer = module.getType(variable.pointerType);
+
+    if (!pointer || pointer->opcode != opTypePointer) {
+      continue;
+    }
+
+    uint32_t typeId = pointer->operands[1];
+
+    if (variable.storageClass == storagePushConstant) {
+      const Type* block = module.getType(typeId);
+
+      if (!block || block->opcode != opTypeStruct || block->operands.empty()) {
+        continue;
+      }
+
+      uint32_t begin = UINT32_MAX;
+
+      for (uint32_t member = 0; member < block->operands.size(); ++member) {
+        begin = std::min(begin, module.getMemberDecoration(typeId, member, decorationOffset).value_or(0));
+      }
+
+      reflection.pushConstantOffset = begin;
+      reflection.pushConstantSize = module.getSize(typeId) - begin;
+      continue;
+    }
+
+    if (variable.storageClass == storageInput) {
+      if (reflection.stage != SpirvReflection::Stage::vertex || module.getDecoration(variable.id, decorationBuiltIn)) {
+        continue;
+      }
+
+      std::optional<uint32_t> location = module.getDecoration(variable.id, decorationLocation);
+      const Type* type = module.getType(typeId);
+
+      if (!location || !type) {
+        continue;
+      }
+
+      uint32_t components = 1;
+
+      if (type->opcode == opTypeVector) {
+        components = type->operands[1];
+        type = module.getType(type->operands[0]);
+      }
+
+      //Matrices and structs span several locations, they aren't vertex
+      //formats and are left to the pipeline description.
+      if (!type || (type->opcode != opTypeFloat && type->opcode != opTypeInt)) {
+        continue;
+      }
+
+      SpirvReflection::ScalarType scalarType = SpirvReflection::ScalarType::floatType;
+
+      if (type->opcode == opTypeInt) {
+        scalarType = type->operands[1] ? SpirvReflection::ScalarType::intType : SpirvReflection::ScalarType::uintType;
+      }
+
+      reflection.vertexInputs.push_back({*location, scalarType, type->operands[0], components});
+      continue;
+    }
+
+    uint32_t count = 1;
+    const Type* type = module.getType(typeId);
+
+    while (type && (type->opcode == opTypeArray || type->opcode == opTypeRuntimeArray)) {
+      if (type->opcode == opTypeArray) {
+        auto length = module.constants.find(type->operands[1]);
+        count *= length != module.constants.end() ? length->second : 1;
+      } else {
+        count = 0;
+      }
+
+      typeId = type->operands[0];
+      type = module.getType(typeId);
+    }
+
+    std::optional<SpirvReflection::DescriptorKind> kind = getDescriptorKind(module, variable.storageClass, typeId);
+    std::optional<uint32_t> binding = module.getDecoration(variable.id, decorationBinding);
+
+    if (!kind || !binding) {
+      continue;
+    }
+
+    reflection.bindings.push_back({
+      module.getDecoration(variable.id, decorationDescriptorSet).value_or(0),
+      *binding,
+      *kind,
+      count
+    });
+  }
+
+  std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const SpirvReflection::Binding& a, const SpirvReflection::Binding& b) {
+    return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+  });
+
+  std::sort(reflection.vertexInputs.begin(), reflection.vertexInputs.end(), [](const SpirvReflection::VertexInput& a, const SpirvReflection::VertexInput& b) {
+    return a.location < b.location;
+  });
+
+  std::sort(specializationIds.begin(), specializationIds.end());
+  specializationIds.erase(std::unique(specializationIds.begin(), specializationIds.end()), specializationIds.end());
+  reflection.specializationIds = std::move(specializationIds);
+
+  return reflection;
+}
+
+} //namespace benpu
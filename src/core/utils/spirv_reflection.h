@@ -0,0 +1,71 @@
+#ifndef BENPU_SPIRV_REFLECTION_H_
+#define BENPU_SPIRV_REFLECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace benpu {
+
+// Interface of a single SPIR-V module, as much as is needed to build the
+// layouts of the pipelines using it.
+struct SpirvReflection {
+  enum class Stage {
+    vertex,
+    fragment,
+    compute,
+    other
+  };
+
+  enum class DescriptorKind {
+    sampler,
+    combinedImageSampler,
+    sampledImage,
+    storageImage,
+    uniformTexelBuffer,
+    storageTexelBuffer,
+    uniformBuffer,
+    storageBuffer
+  };
+
+  enum class ScalarType {
+    floatType,
+    intType,
+    uintType
+  };
+
+  struct Binding {
+    uint32_t set;
+    uint32_t binding;
+    DescriptorKind kind;
+    // 0 for runtime sized arrays.
+    uint32_t count;
+  };
+
+  struct VertexInput {
+    uint32_t location;
+    ScalarType type;
+    // Bits per component.
+    uint32_t width;
+    uint32_t components;
+  };
+
+  Stage stage = Stage::other;
+  // Sorted by set and binding.
+  std::vector<Binding> bindings;
+  // Both 0 when the module has no push constant block.
+  uint32_t pushConstantOffset = 0;
+  uint32_t pushConstantSize = 0;
+  // Vertex stage only, sorted by location, built-ins left out.
+  std::vector<VertexInput> vertexInputs;
+  // Sorted.
+  std::vector<uint32_t> specializationIds;
+};
+
+// Null if code isn't a well formed SPIR-V module.
+std::optional<SpirvReflection> reflectSpirv(const uint32_t* code, size_t wordCount);
+
+} //namespace benpu
+
+#endif
@@ -20,10 +20,11 @@ void System::printHelp() {
   std::cout << R"(
 Benpu - )" << BENPU_VERSION_MAJOR << "." << BENPU_VERSION_MINOR << "." << BENPU_VERSION_PATCH << R"( - Ian Cisneros 2023
 
-Usage: benpu [-c path] 
+Usage: benpu [-c path] [-H]
 
 Arguments
 	-c		Configuration path
+	-H		Headless offscreen rendering
 
 )";
 }
@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include "core/utils/thread_pool.h"
+
+namespace benpu {
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+
+  threadCount = std::max(threadCount, 1u);
+  workers.reserve(threadCount);
+
+  for (uint32_t i = 0; i < threadCount; ++i) {
+    workers.emplace_back(&ThreadPool::run, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  jobAvailable.notify_all();
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::submit(Job job) {
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(std::move(job));
+  }
+  jobAvailable.notify_one();
+}
+
+void ThreadPool::dispatch(uint32_t taskCount, const std::function<void(uint32_t task, uint32_t worker)>& task) {
+
+  if (taskCount == 0) {
+    return;
+  }
+
+  std::mutex doneMutex;
+  std::condition_variable done;
+  uint32_t remaining = taskCount;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint32_t i = 0; i < taskCount; ++i) {
+      jobs.push_back([&, i](uint32_t worker) {
+        task(i, worker);
+
+        std::lock_guard<std::mutex> doneLock(doneMutex);
+        if (--remaining == 0) {
+          done.notify_one();
+        }
+      });
+    }
+  }
+  jobAvailable.notify_all();
+
+  std::unique_lock<std::mutex> lock(doneMutex);
+  done.wait(lock, [&remaining]() { return remaining == 0; });
+}
+
+void ThreadPool::run(uint32_t worker) {
+
+  while (true) {
+    Job job;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+      if (stopping && jobs.empty()) {
+        return;
+      }
+
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+
+    job(worker);
+  }
+}
+
+} //namespace benpu
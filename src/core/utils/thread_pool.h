@@ -0,0 +1,45 @@
+#ifndef BENPU_THREAD_POOL_H_
+#define BENPU_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace benpu {
+
+// Fixed set of worker threads. Jobs receive the index of the worker running
+// them, so callers can keep per-worker state (e.g. command pools) without
+// locking.
+class ThreadPool {
+public:
+  using Job = std::function<void(uint32_t worker)>;
+
+  ThreadPool(uint32_t threadCount);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void submit(Job job);
+  void dispatch(uint32_t taskCount, const std::function<void(uint32_t task, uint32_t worker)>& task);
+
+  uint32_t getThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+private:
+  std::vector<std::thread> workers;
+  std::deque<Job> jobs;
+  std::mutex mutex;
+  std::condition_variable jobAvailable;
+  bool stopping = false;
+
+private:
+  void run(uint32_t worker);
+};
+
+} //namespace benpu
+
+#endif
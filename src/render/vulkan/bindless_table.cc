@@ -0,0 +1,237 @@
+
+#include <algorithm>
+#include <array>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/bindless_table.h"
+
+namespace benpu {
+
+BindlessTable::BindlessTable(vk::Device& device): device{device} {
+
+}
+
+StatusCode BindlessTable::initialize(vk::PhysicalDevice physicalDevice, uint32_t storageBufferCount, uint32_t samplerCount, uint32_t sampledImageCount) {
+
+  auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+  const vk::PhysicalDeviceVulkan12Properties& limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+  storageBuffers.capacity = std::min({
+    storageBufferCount,
+    limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+    limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers
+  });
+  samplers.capacity = std::min({
+    samplerCount,
+    limits.maxDescriptorSetUpdateAfterBindSamplers,
+    limits.maxPerStageDescriptorUpdateAfterBindSamplers
+  });
+  sampledImages.capacity = std::min({
+    sampledImageCount,
+    limits.maxDescriptorSetUpdateAfterBindSampledImages,
+    limits.maxPerStageDescriptorUpdateAfterBindSampledImages
+  });
+
+  BOOST_LOG_TRIVIAL(info) << "Creating bindless table with " << storageBuffers.capacity << " storage buffers, "
+    << samplers.capacity << " samplers and " << sampledImages.capacity << " sampled images.";
+
+  std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {
+    vk::DescriptorSetLayoutBinding(
+      storageBufferBinding,
+      vk::DescriptorType::eStorageBuffer,
+      storageBuffers.capacity,
+      vk::ShaderStageFlagBits::eAll
+    ),
+    vk::DescriptorSetLayoutBinding(
+      samplerBinding,
+      vk::DescriptorType::eSampler,
+      samplers.capacity,
+      vk::ShaderStageFlagBits::eAll
+    ),
+    vk::DescriptorSetLayoutBinding(
+      sampledImageBinding,
+      vk::DescriptorType::eSampledImage,
+      sampledImages.capacity,
+      vk::ShaderStageFlagBits::eAll
+    )
+  };
+
+  // Only the last binding may have a variable count, sampled images are by
+  // far the most numerous so they get it.
+  vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::eUpdateAfterBind
+    | vk::DescriptorBindingFlagBits::ePartiallyBound;
+
+  std::array<vk::DescriptorBindingFlags, 3> flags = {
+    bindingFlags,
+    bindingFlags,
+    bindingFlags | vk::DescriptorBindingFlagBits::eVariableDescriptorCount
+  };
+
+  vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo(flags);
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo(
+    vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+    bindings,
+    &bindingFlagsInfo
+  );
+
+  std::array<vk::DescriptorPoolSize, 3> poolSizes = {
+    vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, storageBuffers.capacity),
+    vk::DescriptorPoolSize(vk::DescriptorType::eSampler, samplers.capacity),
+    vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, sampledImages.capacity)
+  };
+
+  vk::DescriptorPoolCreateInfo poolInfo(
+    vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+    1,
+    poolSizes
+  );
+
+  try {
+
+    layout = device.createDescriptorSetLayout(layoutInfo);
+    pool = device.createDescriptorPool(poolInfo);
+
+    uint32_t variableCount = sampledImages.capacity;
+    vk::DescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo(1, &variableCount);
+
+    vk::DescriptorSetAllocateInfo allocateInfo(
+      pool,
+      layout,
+      &variableCountInfo
+    );
+
+    descriptorSet = device.allocateDescriptorSets(allocateInfo).front();
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while bindless table creation: " << e.what();
+    return StatusCode::descriptorCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode BindlessTable::addStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range, uint32_t& index) {
+
+  if (!acquire(storageBuffers, index)) {
+    BOOST_LOG_TRIVIAL(error) << "Bindless table is out of storage buffer slots.";
+    return StatusCode::descriptorCreationError;
+  }
+
+  vk::DescriptorBufferInfo bufferInfo(buffer, offset, range);
+
+  vk::WriteDescriptorSet write(
+    descriptorSet,
+    storageBufferBinding,
+    index,
+    1,
+    vk::DescriptorType::eStorageBuffer,
+    nullptr,
+    &bufferInfo
+  );
+
+  device.updateDescriptorSets(write, {});
+
+  return StatusCode::success;
+}
+
+StatusCode BindlessTable::addSampler(vk::Sampler sampler, uint32_t& index) {
+
+  if (!acquire(samplers, index)) {
+    BOOST_LOG_TRIVIAL(error) << "Bindless table is out of sampler slots.";
+    return StatusCode::descriptorCreationError;
+  }
+
+  vk::DescriptorImageInfo imageInfo(sampler);
+
+  vk::WriteDescriptorSet write(
+    descriptorSet,
+    samplerBinding,
+    index,
+    1,
+    vk::DescriptorType::eSampler,
+    &imageInfo
+  );
+
+  device.updateDescriptorSets(write, {});
+
+  return StatusCode::success;
+}
+
+StatusCode BindlessTable::addSampledImage(vk::ImageView imageView, vk::ImageLayout layout, uint32_t& index) {
+
+  if (!acquire(sampledImages, index)) {
+    BOOST_LOG_TRIVIAL(error) << "Bindless table is out of sampled image slots.";
+    return StatusCode::descriptorCreationError;
+  }
+
+  vk::DescriptorImageInfo imageInfo(nullptr, imageView, layout);
+
+  vk::WriteDescriptorSet write(
+    descriptorSet,
+    sampledImageBinding,
+    index,
+    1,
+    vk::DescriptorType::eSampledImage,
+    &imageInfo
+  );
+
+  device.updateDescriptorSets(write, {});
+
+  return StatusCode::success;
+}
+
+void BindlessTable::removeStorageBuffer(uint32_t index, Timeline& timeline) {
+  release(storageBuffers, index, timeline);
+}
+
+void BindlessTable::removeSampler(uint32_t index, Timeline& timeline) {
+  release(samplers, index, timeline);
+}
+
+void BindlessTable::removeSampledImage(uint32_t index, Timeline& timeline) {
+  release(sampledImages, index, timeline);
+}
+
+void BindlessTable::bind(vk::CommandBuffer commandBuffer, vk::PipelineBindPoint bindPoint, vk::PipelineLayout pipelineLayout) const {
+  commandBuffer.bindDescriptorSets(bindPoint, pipelineLayout, 0, descriptorSet, {});
+}
+
+vk::DescriptorSetLayout BindlessTable::getLayout() const {
+  return layout;
+}
+
+vk::DescriptorSet BindlessTable::getDescriptorSet() const {
+  return descriptorSet;
+}
+
+bool BindlessTable::acquire(Slots& slots, uint32_t& index) {
+
+  if (!slots.freeIndices.empty()) {
+    index = slots.freeIndices.back();
+    slots.freeIndices.pop_back();
+    return true;
+  }
+
+  if (slots.next == slots.capacity) {
+    return false;
+  }
+
+  index = slots.next++;
+
+  return true;
+}
+
+void BindlessTable::release(Slots& slots, uint32_t index, Timeline& timeline) {
+
+  // Partially bound slots may stay stale, they only have to outlive the
+  // submissions that could still index them.
+  Slots* owner = &slots;
+
+  timeline.retire(timeline.getLastSubmittedValue(), [owner, index]() {
+    owner->freeIndices.push_back(index);
+  });
+}
+
+} //namespace benpu
@@ -0,0 +1,64 @@
+#ifndef BENPU_BINDLESS_TABLE_H_
+#define BENPU_BINDLESS_TABLE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "render/vulkan/timeline.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Global descriptor set holding every storage buffer, sampler and sampled
+// image, addressed by index from shaders (see shaders/bindless.glsl). The
+// set is bound once per command buffer. Slots are written with
+// update-after-bind, so registering resources never invalidates recorded
+// work, and freed slots are only reused once the GPU is done with them.
+class BindlessTable {
+public:
+  static constexpr uint32_t storageBufferBinding = 0;
+  static constexpr uint32_t samplerBinding = 1;
+  static constexpr uint32_t sampledImageBinding = 2;
+
+  BindlessTable(vk::Device& device);
+
+  StatusCode initialize(vk::PhysicalDevice physicalDevice, uint32_t storageBufferCount, uint32_t samplerCount, uint32_t sampledImageCount);
+
+  StatusCode addStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range, uint32_t& index);
+  StatusCode addSampler(vk::Sampler sampler, uint32_t& index);
+  StatusCode addSampledImage(vk::ImageView imageView, vk::ImageLayout layout, uint32_t& index);
+
+  void removeStorageBuffer(uint32_t index, Timeline& timeline);
+  void removeSampler(uint32_t index, Timeline& timeline);
+  void removeSampledImage(uint32_t index, Timeline& timeline);
+
+  void bind(vk::CommandBuffer commandBuffer, vk::PipelineBindPoint bindPoint, vk::PipelineLayout pipelineLayout) const;
+
+  vk::DescriptorSetLayout getLayout() const;
+  vk::DescriptorSet getDescriptorSet() const;
+
+private:
+  struct Slots {
+    uint32_t capacity = 0;
+    uint32_t next = 0;
+    std::vector<uint32_t> freeIndices;
+  };
+
+  vk::Device& device;
+  vk::DescriptorSetLayout layout = nullptr;
+  vk::DescriptorPool pool = nullptr;
+  vk::DescriptorSet descriptorSet = nullptr;
+  Slots storageBuffers;
+  Slots samplers;
+  Slots sampledImages;
+
+private:
+  bool acquire(Slots& slots, uint32_t& index);
+  void release(Slots& slots, uint32_t index, Timeline& timeline);
+};
+
+} //namespace benpu
+
+#endif
@@ -9,13 +9,15 @@ CommandPool::CommandPool(vk::Device& device): device{device} {
 
 }
 
-StatusCode CommandPool::initialize(const QueueFamilyIndices& queueFamilyIndices) {
+StatusCode CommandPool::initialize(uint32_t queueFamily, uint32_t framesInFlight) {
 
-  BOOST_LOG_TRIVIAL(info) << "Creating command pool.";
+  BOOST_LOG_TRIVIAL(info) << "Creating command pool for " << framesInFlight << " frames in flight.";
+
+  frames.resize(framesInFlight);
 
   vk::CommandPoolCreateInfo poolInfo(
     {vk::CommandPoolCreateFlagBits::eResetCommandBuffer},
-    queueFamilyIndices.graphicsFamily.value()
+    queueFamily
   );
 
   try {
@@ -33,19 +35,21 @@ StatusCode CommandPool::initialize(const QueueFamilyIndices& queueFamilyIndices)
   return StatusCode::success;
 }
 
-StatusCode CommandPool::createCommandBuffer() {
+StatusCode CommandPool::createCommandBuffers() {
 
-  BOOST_LOG_TRIVIAL(info) << "Creating command buffer.";
+  BOOST_LOG_TRIVIAL(info) << "Creating command buffers.";
 
   vk::CommandBufferAllocateInfo allocInfo(
     commandPool,
     vk::CommandBufferLevel::ePrimary,
-    1
+    static_cast<uint32_t>(frames.size())
   );
 
+  std::vector<vk::CommandBuffer> commandBuffers(frames.size());
+
   try {
-    
-    if (device.allocateCommandBuffers(&allocInfo, &commandBuffer) != vk::Result::eSuccess) {
+
+    if (device.allocateCommandBuffers(&allocInfo, commandBuffers.data()) != vk::Result::eSuccess) {
       BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while command buffer creation.";
       return StatusCode::commandBufferCreationError;
     }
@@ -55,6 +59,10 @@ StatusCode CommandPool::createCommandBuffer() {
     return StatusCode::commandBufferCreationError;
   }
 
+  for (size_t i = 0; i < frames.size(); ++i) {
+    frames[i].commandBuffers.push_back(commandBuffers[i]);
+  }
+
   return StatusCode::success;
 }
 
@@ -62,31 +70,59 @@ StatusCode CommandPool::createSyncObjects() {
 
   BOOST_LOG_TRIVIAL(info) << "Creating synchronization objects.";
 
+  // Frame completion is tracked through the renderer timeline, only the
+  // binary semaphore required by acquire is created per frame. The ones
+  // present waits on belong to the swapchain images.
   vk::SemaphoreCreateInfo sCreateInfo;
-  
-  if (device.createSemaphore(&sCreateInfo, nullptr, &imageAvailableSemaphore) != vk::Result::eSuccess) {
-    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while image semaphore creation.";
-    return StatusCode::semaphoreCreationError;
-  }
-  
-  if (device.createSemaphore(&sCreateInfo, nullptr, &renderFinishedSemaphore) != vk::Result::eSuccess) {
-    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while render semaphore creation.";
-    return StatusCode::semaphoreCreationError;
-  }
 
-  vk::FenceCreateInfo fCreateInfo(
-    (
-      vk::FenceCreateFlagBits::eSignaled
-    )
-  );
-  
-  if (device.createFence(&fCreateInfo, nullptr, &inFlightFence) != vk::Result::eSuccess) {
-    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while fence creation.";
-    return StatusCode::fenceCreationError;
+  for (FrameResources& frame : frames) {
+
+    if (device.createSemaphore(&sCreateInfo, nullptr, &frame.imageAvailableSemaphore) != vk::Result::eSuccess) {
+      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while image semaphore creation.";
+      return StatusCode::semaphoreCreationError;
+    }
   }
 
   return StatusCode::success;
 }
 
+uint32_t CommandPool::getFramesInFlight() const {
+  return static_cast<uint32_t>(frames.size());
+}
+
+FrameResources& CommandPool::getFrame(uint32_t frameIndex) {
+  return frames[frameIndex];
+}
+
+vk::CommandBuffer CommandPool::nextCommandBuffer(uint32_t frameIndex) {
+
+  FrameResources& frame = frames[frameIndex];
+
+  // A frame submits one command buffer per render graph batch, extra ones
+  // are allocated the first time a frame needs them.
+  if (frame.usedCommandBuffers == frame.commandBuffers.size()) {
+    vk::CommandBufferAllocateInfo allocInfo(
+      commandPool,
+      vk::CommandBufferLevel::ePrimary,
+      1
+    );
+
+    try {
+
+      frame.commandBuffers.push_back(device.allocateCommandBuffers(allocInfo).front());
+
+    } catch (vk::SystemError& e) {
+      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while command buffer creation: " << e.what();
+      return nullptr;
+    }
+  }
+
+  return frame.commandBuffers[frame.usedCommandBuffers++];
+}
+
+void CommandPool::resetCommandBuffers(uint32_t frameIndex) {
+  frames[frameIndex].usedCommandBuffers = 0;
+}
+
 } //namespace benpu
 
@@ -1,6 +1,8 @@
 #ifndef BENPU_COMMAND_POOL_H_
 #define BENPU_COMMAND_POOL_H_
 
+#include <vector>
+
 #include <vulkan/vulkan.hpp>
 
 #include "status_code.h"
@@ -8,26 +10,37 @@
 
 namespace benpu {
 
+struct FrameResources {
+  std::vector<vk::CommandBuffer> commandBuffers;
+  uint32_t usedCommandBuffers = 0;
+  vk::Semaphore imageAvailableSemaphore = nullptr;
+  uint64_t timelineValue = 0;
+  uint64_t computeTimelineValue = 0;
+};
+
 class CommandPool {
 public:
   CommandPool(vk::Device& device);
 
-  StatusCode initialize(const QueueFamilyIndices& queueFamilyIndices);
-  StatusCode createCommandBuffer();
+  StatusCode initialize(uint32_t queueFamily, uint32_t framesInFlight);
+  StatusCode createCommandBuffers();
   StatusCode createSyncObjects();
 
+  uint32_t getFramesInFlight() const;
+  FrameResources& getFrame(uint32_t frameIndex);
+
+  vk::CommandBuffer nextCommandBuffer(uint32_t frameIndex);
+  void resetCommandBuffers(uint32_t frameIndex);
+
 private:
   vk::Device& device;
   vk::CommandPool commandPool = nullptr;
-  vk::CommandBuffer commandBuffer = nullptr;
-  vk::Semaphore imageAvailableSemaphore = nullptr;
-  vk::Semaphore renderFinishedSemaphore = nullptr;
-  vk::Fence inFlightFence ;
+  std::vector<FrameResources> frames;
 
 private:
-  
+
 };
 
 } //namespace benpu
 
-#endif
\ No newline at end of file
+#endif
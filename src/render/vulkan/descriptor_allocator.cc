@@ -0,0 +1,151 @@
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/descriptor_allocator.h"
+
+namespace benpu {
+
+static constexpr uint32_t maxSetsPerPool = 4096;
+
+DescriptorAllocator::DescriptorAllocator(vk::Device& device): device{device} {
+
+}
+
+StatusCode DescriptorAllocator::initialize(uint32_t framesInFlight, uint32_t setsPerPool, const std::vector<PoolSizeRatio>& ratios) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating descriptor allocator with " << setsPerPool << " sets per pool.";
+
+  this->setsPerPool = setsPerPool;
+  this->ratios = ratios;
+
+  frames.resize(framesInFlight);
+
+  for (FramePools& frame : frames) {
+    vk::DescriptorPool pool;
+
+    if (createPool(setsPerPool, pool) != StatusCode::success) {
+      return StatusCode::descriptorCreationError;
+    }
+
+    frame.readyPools.push_back(pool);
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode DescriptorAllocator::beginFrame(uint32_t frameIndex) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  currentFrame = frameIndex;
+  FramePools& frame = frames[currentFrame];
+
+  try {
+
+    for (vk::DescriptorPool pool : frame.usedPools) {
+      device.resetDescriptorPool(pool);
+      frame.readyPools.push_back(pool);
+    }
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while descriptor pool reset: " << e.what();
+    return StatusCode::descriptorCreationError;
+  }
+
+  frame.usedPools.clear();
+
+  return StatusCode::success;
+}
+
+StatusCode DescriptorAllocator::allocate(vk::DescriptorSetLayout layout, vk::DescriptorSet& descriptorSet) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  FramePools& frame = frames[currentFrame];
+
+  // The last used pool is the one still being filled, a failure there
+  // means it's exhausted and the next one is tried once.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    if (frame.usedPools.empty() || attempt > 0) {
+      vk::DescriptorPool pool;
+
+      if (nextPool(frame, pool) != StatusCode::success) {
+        return StatusCode::descriptorCreationError;
+      }
+
+      frame.usedPools.push_back(pool);
+    }
+
+    vk::DescriptorSetAllocateInfo allocateInfo(
+      frame.usedPools.back(),
+      layout
+    );
+
+    try {
+
+      descriptorSet = device.allocateDescriptorSets(allocateInfo).front();
+      return StatusCode::success;
+
+    } catch (vk::OutOfPoolMemoryError&) {
+      continue;
+    } catch (vk::FragmentedPoolError&) {
+      continue;
+    } catch (vk::SystemError& e) {
+      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while descriptor set allocation: " << e.what();
+      return StatusCode::descriptorCreationError;
+    }
+  }
+
+  BOOST_LOG_TRIVIAL(error) << "Descriptor set doesn't fit in an empty pool.";
+  return StatusCode::descriptorCreationError;
+}
+
+StatusCode DescriptorAllocator::nextPool(FramePools& frame, vk::DescriptorPool& pool) {
+
+  if (!frame.readyPools.empty()) {
+    pool = frame.readyPools.back();
+    frame.readyPools.pop_back();
+    return StatusCode::success;
+  }
+
+  // Every new pool is larger than the last, so a frame that needs many
+  // sets settles on a few big pools.
+  setsPerPool = std::min(setsPerPool + setsPerPool / 2, maxSetsPerPool);
+
+  BOOST_LOG_TRIVIAL(debug) << "Growing descriptor pools of frame " << currentFrame << " with " << setsPerPool << " sets.";
+
+  return createPool(setsPerPool, pool);
+}
+
+StatusCode DescriptorAllocator::createPool(uint32_t setCount, vk::DescriptorPool& pool) {
+
+  std::vector<vk::DescriptorPoolSize> poolSizes;
+
+  for (const PoolSizeRatio& ratio : ratios) {
+    poolSizes.emplace_back(
+      ratio.type,
+      std::max(static_cast<uint32_t>(ratio.ratio * setCount), 1u)
+    );
+  }
+
+  vk::DescriptorPoolCreateInfo poolInfo(
+    {},
+    setCount,
+    poolSizes
+  );
+
+  try {
+
+    pool = device.createDescriptorPool(poolInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while descriptor pool creation: " << e.what();
+    return StatusCode::descriptorCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+} //namespace benpu
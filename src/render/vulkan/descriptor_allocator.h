@@ -0,0 +1,52 @@
+#ifndef BENPU_DESCRIPTOR_ALLOCATOR_H_
+#define BENPU_DESCRIPTOR_ALLOCATOR_H_
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "status_code.h"
+
+namespace benpu {
+
+// Transient descriptor sets for whatever doesn't go through the bindless
+// table. Sets are carved out of a growable list of pools per frame in
+// flight and are never freed one by one, the frame's pools are reset in
+// bulk once the frame has retired.
+class DescriptorAllocator {
+public:
+  struct PoolSizeRatio {
+    vk::DescriptorType type;
+    float ratio;
+  };
+
+  DescriptorAllocator(vk::Device& device);
+
+  StatusCode initialize(uint32_t framesInFlight, uint32_t setsPerPool, const std::vector<PoolSizeRatio>& ratios);
+
+  StatusCode beginFrame(uint32_t frameIndex);
+  StatusCode allocate(vk::DescriptorSetLayout layout, vk::DescriptorSet& descriptorSet);
+
+private:
+  struct FramePools {
+    std::vector<vk::DescriptorPool> usedPools;
+    std::vector<vk::DescriptorPool> readyPools;
+  };
+
+  vk::Device& device;
+  std::vector<PoolSizeRatio> ratios;
+  uint32_t setsPerPool = 0;
+  std::vector<FramePools> frames;
+  uint32_t currentFrame = 0;
+  std::mutex mutex;
+
+private:
+  StatusCode nextPool(FramePools& frame, vk::DescriptorPool& pool);
+  StatusCode createPool(uint32_t setCount, vk::DescriptorPool& pool);
+};
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef BENPU_EMBEDDED_SHADERS_H_
+#define BENPU_EMBEDDED_SHADERS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace benpu {
+
+// SPIR-V compiled into the binary by the shaders target, so loading a
+// shader module doesn't touch the filesystem.
+struct EmbeddedShader {
+  const char* name;
+  const uint32_t* code;
+  // In bytes, as vk::ShaderModuleCreateInfo expects.
+  size_t size;
+};
+
+// Looks a shader up by its SPIR-V file name, e.g. "first.vert.spv". Null if
+// no such shader was compiled.
+const EmbeddedShader* findEmbeddedShader(std::string_view name);
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,90 @@
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/geometry_buffer.h"
+
+namespace benpu {
+
+GeometryBuffer::GeometryBuffer(vk::Device& device, MemoryAllocator& memoryAllocator): device{device}, memoryAllocator{memoryAllocator} {
+
+}
+
+StatusCode GeometryBuffer::initialize(uint32_t vertexCapacity, uint32_t indexCapacity) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating geometry buffers for " << vertexCapacity << " vertices and " << indexCapacity << " indices.";
+
+  this->vertexCapacity = vertexCapacity;
+  this->indexCapacity = indexCapacity;
+
+  if (memoryAllocator.createBuffer(
+      static_cast<vk::DeviceSize>(vertexCapacity) * sizeof(Vertex),
+      vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+      vk::MemoryPropertyFlagBits::eDeviceLocal,
+      vertexBuffer,
+      vertexMemory
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create vertex buffer.";
+    return StatusCode::bufferCreationError;
+  }
+
+  if (memoryAllocator.createBuffer(
+      static_cast<vk::DeviceSize>(indexCapacity) * sizeof(uint32_t),
+      vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+      vk::MemoryPropertyFlagBits::eDeviceLocal,
+      indexBuffer,
+      indexMemory
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create index buffer.";
+    return StatusCode::bufferCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode GeometryBuffer::addMesh(UploadEngine& uploadEngine, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Mesh& mesh) {
+
+  if (vertices.size() > vertexCapacity - vertexCount || indices.size() > indexCapacity - indexCount) {
+    BOOST_LOG_TRIVIAL(error) << "Geometry buffers can't fit a mesh of " << vertices.size() << " vertices and " << indices.size() << " indices.";
+    return StatusCode::memoryAllocationError;
+  }
+
+  if (uploadEngine.uploadBuffer(
+      vertexBuffer,
+      static_cast<vk::DeviceSize>(vertexCount) * sizeof(Vertex),
+      vertices.data(),
+      vertices.size() * sizeof(Vertex)
+    ) != StatusCode::success) {
+    return StatusCode::memoryAllocationError;
+  }
+
+  if (uploadEngine.uploadBuffer(
+      indexBuffer,
+      static_cast<vk::DeviceSize>(indexCount) * sizeof(uint32_t),
+      indices.data(),
+      indices.size() * sizeof(uint32_t)
+    ) != StatusCode::success) {
+    return StatusCode::memoryAllocationError;
+  }
+
+  // Indices stay local to the mesh, the vertex offset rebases them.
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  mesh.firstIndex = indexCount;
+  mesh.vertexOffset = static_cast<int32_t>(vertexCount);
+
+  vertexCount += static_cast<uint32_t>(vertices.size());
+  indexCount += static_cast<uint32_t>(indices.size());
+
+  return StatusCode::success;
+}
+
+void GeometryBuffer::bind(vk::CommandBuffer commandBuffer) const {
+  vk::DeviceSize offset = 0;
+  commandBuffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+  commandBuffer.bindIndexBuffer(indexBuffer, 0, vk::IndexType::eUint32);
+}
+
+void GeometryBuffer::draw(vk::CommandBuffer commandBuffer, const Mesh& mesh, uint32_t instanceCount) const {
+  commandBuffer.drawIndexed(mesh.indexCount, instanceCount, mesh.firstIndex, mesh.vertexOffset, 0);
+}
+
+} //namespace benpu
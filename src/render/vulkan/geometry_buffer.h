@@ -0,0 +1,51 @@
+#ifndef BENPU_GEOMETRY_BUFFER_H_
+#define BENPU_GEOMETRY_BUFFER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "render/vulkan/memory_allocator.h"
+#include "render/vulkan/upload_engine.h"
+#include "render/vulkan/vertex.h"
+#include "status_code.h"
+
+namespace benpu {
+
+struct Mesh {
+  uint32_t indexCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t vertexOffset = 0;
+};
+
+// Device local vertex and index buffers shared by every mesh. Meshes are
+// appended as ranges and filled through the upload engine, so all of them
+// draw with a single pair of buffer bindings.
+class GeometryBuffer {
+public:
+  GeometryBuffer(vk::Device& device, MemoryAllocator& memoryAllocator);
+
+  StatusCode initialize(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+  StatusCode addMesh(UploadEngine& uploadEngine, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Mesh& mesh);
+
+  void bind(vk::CommandBuffer commandBuffer) const;
+  void draw(vk::CommandBuffer commandBuffer, const Mesh& mesh, uint32_t instanceCount = 1) const;
+
+private:
+  vk::Device& device;
+  MemoryAllocator& memoryAllocator;
+  vk::Buffer vertexBuffer = nullptr;
+  vk::Buffer indexBuffer = nullptr;
+  MemoryAllocation vertexMemory;
+  MemoryAllocation indexMemory;
+  uint32_t vertexCapacity = 0;
+  uint32_t indexCapacity = 0;
+  uint32_t vertexCount = 0;
+  uint32_t indexCount = 0;
+};
+
+} //namespace benpu
+
+#endif
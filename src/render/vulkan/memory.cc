@@ -0,0 +1,19 @@
+
+#include "render/vulkan/memory.h"
+
+namespace benpu {
+
+std::optional<uint32_t> findMemoryType(vk::PhysicalDevice physicalDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
+
+  vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
+
+  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+    if ((typeFilter & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+      return i;
+    }
+  }
+
+  return std::nullopt;
+}
+
+} //namespace benpu
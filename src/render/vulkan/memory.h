@@ -0,0 +1,15 @@
+#ifndef BENPU_MEMORY_H_
+#define BENPU_MEMORY_H_
+
+#include <cstdint>
+#include <optional>
+
+#include <vulkan/vulkan.hpp>
+
+namespace benpu {
+
+std::optional<uint32_t> findMemoryType(vk::PhysicalDevice physicalDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties);
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,373 @@
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/memory.h"
+#include "render/vulkan/memory_allocator.h"
+
+namespace benpu {
+
+MemoryAllocator::MemoryAllocator(vk::Device& device): device{device} {
+
+}
+
+StatusCode MemoryAllocator::initialize(vk::PhysicalDevice physicalDevice, vk::DeviceSize blockSize) {
+
+  this->physicalDevice = physicalDevice;
+
+  memoryProperties = physicalDevice.getMemoryProperties();
+  vk::PhysicalDeviceLimits limits = physicalDevice.getProperties().limits;
+
+  // Buddy blocks are aligned to their size, keeping the smallest one at
+  // least bufferImageGranularity apart means linear and optimal resources
+  // never share a page.
+  minAllocationSize = std::max<vk::DeviceSize>(256, limits.bufferImageGranularity);
+  maxAllocationCount = limits.maxMemoryAllocationCount;
+
+  blockSizes.resize(memoryProperties.memoryTypeCount);
+  blocks.resize(memoryProperties.memoryTypeCount);
+
+  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+    vk::DeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+    vk::DeviceSize size = blockSize;
+
+    // Small heaps, like the host visible window into device memory, would
+    // be exhausted by a couple of full sized blocks.
+    while (size > heapSize / 8 && size > minAllocationSize) {
+      size /= 2;
+    }
+
+    blockSizes[i] = size;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "Creating memory allocator with " << blockSize << " bytes blocks.";
+
+  return StatusCode::success;
+}
+
+StatusCode MemoryAllocator::allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, MemoryAllocation& allocation) {
+  return allocate(requirements, properties, DedicatedRequest(), allocation);
+}
+
+void MemoryAllocator::free(const MemoryAllocation& allocation) {
+
+  if (!allocation.memory) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (allocation.dedicated) {
+    device.freeMemory(allocation.memory);
+    --dedicatedCount;
+    --liveAllocationCount;
+    dedicatedBytes -= allocation.size;
+    return;
+  }
+
+  std::vector<Block>& typeBlocks = blocks[allocation.memoryType];
+
+  auto block = std::find_if(typeBlocks.begin(), typeBlocks.end(), [&allocation](const Block& candidate) {
+    return candidate.memory == allocation.memory;
+  });
+
+  if (block == typeBlocks.end()) {
+    BOOST_LOG_TRIVIAL(warning) << "Freeing memory that wasn't allocated from a block.";
+    return;
+  }
+
+  block->allocator.free(allocation.offset);
+
+  // One empty block is kept per type so a resource created and destroyed
+  // every frame doesn't hit the driver each time.
+  if (block->allocator.isEmpty() && typeBlocks.size() > 1) {
+    device.freeMemory(block->memory);
+    --liveAllocationCount;
+    typeBlocks.erase(block);
+  }
+}
+
+StatusCode MemoryAllocator::createBuffer(
+  vk::DeviceSize size,
+  vk::BufferUsageFlags usage,
+  vk::MemoryPropertyFlags properties,
+  vk::Buffer& buffer,
+  MemoryAllocation& allocation
+) {
+
+  try {
+
+    vk::BufferCreateInfo bufferInfo(
+      {},
+      size,
+      usage,
+      vk::SharingMode::eExclusive
+    );
+
+    buffer = device.createBuffer(bufferInfo);
+
+    auto requirements = device.getBufferMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(
+      vk::BufferMemoryRequirementsInfo2(buffer)
+    );
+    const vk::MemoryDedicatedRequirements& dedicatedRequirements = requirements.get<vk::MemoryDedicatedRequirements>();
+
+    DedicatedRequest dedicated;
+    dedicated.required = dedicatedRequirements.requiresDedicatedAllocation;
+    dedicated.preferred = dedicatedRequirements.prefersDedicatedAllocation;
+    dedicated.buffer = buffer;
+
+    if (allocate(requirements.get<vk::MemoryRequirements2>().memoryRequirements, properties, dedicated, allocation) != StatusCode::success) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't allocate memory for a buffer of " << size << " bytes.";
+      device.destroyBuffer(buffer);
+      buffer = nullptr;
+      return StatusCode::memoryAllocationError;
+    }
+
+    device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while buffer creation: " << e.what();
+    return StatusCode::bufferCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode MemoryAllocator::createImage(
+  const vk::ImageCreateInfo& imageInfo,
+  vk::MemoryPropertyFlags properties,
+  vk::Image& image,
+  MemoryAllocation& allocation
+) {
+
+  try {
+
+    image = device.createImage(imageInfo);
+
+    auto requirements = device.getImageMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(
+      vk::ImageMemoryRequirementsInfo2(image)
+    );
+    const vk::MemoryDedicatedRequirements& dedicatedRequirements = requirements.get<vk::MemoryDedicatedRequirements>();
+
+    DedicatedRequest dedicated;
+    dedicated.required = dedicatedRequirements.requiresDedicatedAllocation;
+    dedicated.preferred = dedicatedRequirements.prefersDedicatedAllocation;
+    dedicated.image = image;
+
+    if (allocate(requirements.get<vk::MemoryRequirements2>().memoryRequirements, properties, dedicated, allocation) != StatusCode::success) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't allocate memory for a " << imageInfo.extent.width << "x" << imageInfo.extent.height << " image.";
+      device.destroyImage(image);
+      image = nullptr;
+      return StatusCode::memoryAllocationError;
+    }
+
+    device.bindImageMemory(image, allocation.memory, allocation.offset);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while image creation: " << e.what();
+    return StatusCode::imageCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+void MemoryAllocator::destroyBuffer(vk::Buffer buffer, const MemoryAllocation& allocation) {
+  device.destroyBuffer(buffer);
+  free(allocation);
+}
+
+void MemoryAllocator::destroyImage(vk::Image image, const MemoryAllocation& allocation) {
+  device.destroyImage(image);
+  free(allocation);
+}
+
+MemoryStats MemoryAllocator::getStats() const {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  MemoryStats stats;
+  vk::DeviceSize freeBytes = 0;
+  vk::DeviceSize largestFreeBytes = 0;
+
+  for (const std::vector<Block>& typeBlocks : blocks) {
+    for (const Block& block : typeBlocks) {
+      stats.blockCount++;
+      stats.allocationCount += static_cast<uint32_t>(block.allocator.getAllocationCount());
+      stats.reservedBytes += block.allocator.getSize();
+      stats.allocatedBytes += block.allocator.getAllocatedBytes();
+      stats.requestedBytes += block.allocator.getRequestedBytes();
+      freeBytes += block.allocator.getSize() - block.allocator.getAllocatedBytes();
+      largestFreeBytes += block.allocator.getLargestFreeBlock();
+    }
+  }
+
+  stats.dedicatedCount = dedicatedCount;
+  stats.allocationCount += dedicatedCount;
+  stats.reservedBytes += dedicatedBytes;
+  stats.allocatedBytes += dedicatedBytes;
+  stats.requestedBytes += dedicatedBytes;
+
+  if (freeBytes > 0) {
+    stats.fragmentation = 1.0f - static_cast<float>(largestFreeBytes) / static_cast<float>(freeBytes);
+  }
+
+  return stats;
+}
+
+void MemoryAllocator::logStats() const {
+
+  MemoryStats stats = getStats();
+
+  BOOST_LOG_TRIVIAL(info) << "Device memory: " << stats.allocationCount << " allocations in "
+    << stats.blockCount << " blocks and " << stats.dedicatedCount << " dedicated allocations, "
+    << stats.requestedBytes << " bytes requested, " << stats.allocatedBytes << " allocated, "
+    << stats.reservedBytes << " reserved, fragmentation " << stats.fragmentation << ".";
+}
+
+StatusCode MemoryAllocator::allocate(
+  const vk::MemoryRequirements& requirements,
+  vk::MemoryPropertyFlags properties,
+  const DedicatedRequest& dedicated,
+  MemoryAllocation& allocation
+) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  uint32_t typeFilter = requirements.memoryTypeBits;
+
+  // A heap running out falls through to the next type with the same
+  // properties, if there is one.
+  while (true) {
+    std::optional<uint32_t> memoryType = findMemoryType(physicalDevice, typeFilter, properties);
+
+    if (!memoryType.has_value()) {
+      return StatusCode::memoryAllocationError;
+    }
+
+    if (allocateFromType(requirements, memoryType.value(), dedicated, allocation) == StatusCode::success) {
+      return StatusCode::success;
+    }
+
+    typeFilter &= ~(1u << memoryType.value());
+  }
+}
+
+StatusCode MemoryAllocator::allocateFromType(
+  const vk::MemoryRequirements& requirements,
+  uint32_t memoryType,
+  const DedicatedRequest& dedicated,
+  MemoryAllocation& allocation
+) {
+
+  vk::DeviceSize blockSize = blockSizes[memoryType];
+
+  allocation.memoryType = memoryType;
+  allocation.size = requirements.size;
+
+  // Anything over half a block would leave the rest of it unusable for
+  // other resources of the same size.
+  if (dedicated.required || dedicated.preferred || requirements.size > blockSize / 2) {
+    vk::MemoryDedicatedAllocateInfo dedicatedInfo(dedicated.image, dedicated.buffer);
+    const void* next = (dedicated.image || dedicated.buffer) ? &dedicatedInfo : nullptr;
+    uint8_t* mapped = nullptr;
+
+    if (allocateMemory(requirements.size, memoryType, next, allocation.memory, mapped) != StatusCode::success) {
+      return StatusCode::memoryAllocationError;
+    }
+
+    allocation.offset = 0;
+    allocation.mapped = mapped;
+    allocation.dedicated = true;
+
+    ++dedicatedCount;
+    dedicatedBytes += requirements.size;
+
+    return StatusCode::success;
+  }
+
+  std::vector<Block>& typeBlocks = blocks[memoryType];
+
+  for (Block& block : typeBlocks) {
+    std::optional<uint64_t> offset = block.allocator.allocate(requirements.size, requirements.alignment);
+
+    if (offset.has_value()) {
+      allocation.memory = block.memory;
+      allocation.offset = offset.value();
+      allocation.mapped = block.mapped ? block.mapped + offset.value() : nullptr;
+      allocation.dedicated = false;
+      return StatusCode::success;
+    }
+  }
+
+  vk::DeviceMemory memory;
+  uint8_t* mapped = nullptr;
+
+  if (allocateMemory(blockSize, memoryType, nullptr, memory, mapped) != StatusCode::success) {
+    return StatusCode::memoryAllocationError;
+  }
+
+  BOOST_LOG_TRIVIAL(debug) << "New memory block of " << blockSize << " bytes for memory type " << memoryType << ".";
+
+  typeBlocks.push_back({memory, mapped, BuddyAllocator(blockSize, minAllocationSize)});
+  Block& block = typeBlocks.back();
+
+  std::optional<uint64_t> offset = block.allocator.allocate(requirements.size, requirements.alignment);
+
+  if (!offset.has_value()) {
+    return StatusCode::memoryAllocationError;
+  }
+
+  allocation.memory = block.memory;
+  allocation.offset = offset.value();
+  allocation.mapped = block.mapped ? block.mapped + offset.value() : nullptr;
+  allocation.dedicated = false;
+
+  return StatusCode::success;
+}
+
+StatusCode MemoryAllocator::allocateMemory(vk::DeviceSize size, uint32_t memoryType, const void* next, vk::DeviceMemory& memory, uint8_t*& mapped) {
+
+  if (liveAllocationCount >= maxAllocationCount) {
+    BOOST_LOG_TRIVIAL(error) << "Reached maxMemoryAllocationCount (" << maxAllocationCount << ").";
+    return StatusCode::memoryAllocationError;
+  }
+
+  try {
+
+    vk::MemoryAllocateInfo allocateInfo(
+      size,
+      memoryType,
+      next
+    );
+
+    memory = device.allocateMemory(allocateInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(warning) << "Vulkan error ocurred while allocating " << size << " bytes from memory type " << memoryType << ": " << e.what();
+    return StatusCode::memoryAllocationError;
+  }
+
+  // Host visible memory is mapped once for its whole lifetime.
+  if (isHostVisible(memoryType)) {
+    try {
+
+      mapped = static_cast<uint8_t*>(device.mapMemory(memory, 0, VK_WHOLE_SIZE));
+
+    } catch (vk::SystemError& e) {
+      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while memory map: " << e.what();
+      device.freeMemory(memory);
+      return StatusCode::memoryAllocationError;
+    }
+  }
+
+  ++liveAllocationCount;
+
+  return StatusCode::success;
+}
+
+bool MemoryAllocator::isHostVisible(uint32_t memoryType) const {
+  return static_cast<bool>(memoryProperties.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+}
+
+} //namespace benpu
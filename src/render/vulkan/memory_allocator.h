@@ -0,0 +1,116 @@
+#ifndef BENPU_MEMORY_ALLOCATOR_H_
+#define BENPU_MEMORY_ALLOCATOR_H_
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/utils/buddy_allocator.h"
+#include "status_code.h"
+
+namespace benpu {
+
+struct MemoryAllocation {
+  vk::DeviceMemory memory = nullptr;
+  vk::DeviceSize offset = 0;
+  vk::DeviceSize size = 0;
+  void* mapped = nullptr;
+  uint32_t memoryType = 0;
+  bool dedicated = false;
+};
+
+struct MemoryStats {
+  uint32_t blockCount = 0;
+  uint32_t dedicatedCount = 0;
+  uint32_t allocationCount = 0;
+  // Bytes taken from the driver, bytes handed out in buddy blocks and bytes
+  // actually requested, the gaps are external and internal fragmentation.
+  vk::DeviceSize reservedBytes = 0;
+  vk::DeviceSize allocatedBytes = 0;
+  vk::DeviceSize requestedBytes = 0;
+  // 1 - largest free range / free bytes, 0 when every free byte is usable
+  // by a single allocation.
+  float fragmentation = 0.0f;
+};
+
+// Sub-allocates buffers and images from large per memory type blocks so
+// thousands of resources cost a handful of vkAllocateMemory calls. Blocks
+// use buddy placement, host visible blocks stay mapped, and resources the
+// driver wants on their own or that would hog a block get a dedicated
+// allocation.
+class MemoryAllocator {
+public:
+  MemoryAllocator(vk::Device& device);
+
+  StatusCode initialize(vk::PhysicalDevice physicalDevice, vk::DeviceSize blockSize);
+
+  StatusCode allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, MemoryAllocation& allocation);
+  void free(const MemoryAllocation& allocation);
+
+  StatusCode createBuffer(
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage,
+    vk::MemoryPropertyFlags properties,
+    vk::Buffer& buffer,
+    MemoryAllocation& allocation
+  );
+  StatusCode createImage(
+    const vk::ImageCreateInfo& imageInfo,
+    vk::MemoryPropertyFlags properties,
+    vk::Image& image,
+    MemoryAllocation& allocation
+  );
+  void destroyBuffer(vk::Buffer buffer, const MemoryAllocation& allocation);
+  void destroyImage(vk::Image image, const MemoryAllocation& allocation);
+
+  MemoryStats getStats() const;
+  void logStats() const;
+
+private:
+  struct Block {
+    vk::DeviceMemory memory = nullptr;
+    uint8_t* mapped = nullptr;
+    BuddyAllocator allocator;
+  };
+
+  struct DedicatedRequest {
+    bool required = false;
+    bool preferred = false;
+    vk::Buffer buffer = nullptr;
+    vk::Image image = nullptr;
+  };
+
+  vk::Device& device;
+  vk::PhysicalDevice physicalDevice = nullptr;
+  vk::PhysicalDeviceMemoryProperties memoryProperties;
+  vk::DeviceSize minAllocationSize = 256;
+  uint32_t maxAllocationCount = 0;
+  std::vector<vk::DeviceSize> blockSizes;
+  std::vector<std::vector<Block>> blocks;
+  uint32_t dedicatedCount = 0;
+  vk::DeviceSize dedicatedBytes = 0;
+  uint32_t liveAllocationCount = 0;
+  mutable std::mutex mutex;
+
+private:
+  StatusCode allocate(
+    const vk::MemoryRequirements& requirements,
+    vk::MemoryPropertyFlags properties,
+    const DedicatedRequest& dedicated,
+    MemoryAllocation& allocation
+  );
+  StatusCode allocateFromType(
+    const vk::MemoryRequirements& requirements,
+    uint32_t memoryType,
+    const DedicatedRequest& dedicated,
+    MemoryAllocation& allocation
+  );
+  StatusCode allocateMemory(vk::DeviceSize size, uint32_t memoryType, const void* next, vk::DeviceMemory& memory, uint8_t*& mapped);
+  bool isHostVisible(uint32_t memoryType) const;
+};
+
+} //namespace benpu
+
+#endif
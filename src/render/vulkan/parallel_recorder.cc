@@ -0,0 +1,116 @@
+
+#include <atomic>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/parallel_recorder.h"
+
+namespace benpu {
+
+ParallelRecorder::ParallelRecorder(vk::Device& device): device{device} {
+
+}
+
+StatusCode ParallelRecorder::initialize(const QueueFamilyIndices& queueFamilyIndices, uint32_t framesInFlight, uint32_t workerCount) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating " << workerCount << " recording command pools per frame in flight.";
+
+  pools.resize(framesInFlight);
+
+  vk::CommandPoolCreateInfo poolInfo(
+    {vk::CommandPoolCreateFlagBits::eTransient},
+    queueFamilyIndices.graphicsFamily.value()
+  );
+
+  try {
+
+    for (std::vector<WorkerPool>& framePools : pools) {
+      framePools.resize(workerCount);
+
+      for (WorkerPool& pool : framePools) {
+        pool.commandPool = device.createCommandPool(poolInfo);
+      }
+    }
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while recording command pool creation: " << e.what();
+    return StatusCode::commandPoolCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode ParallelRecorder::beginFrame(uint32_t frameIndex) {
+
+  currentFrame = frameIndex;
+
+  // The frame has retired on the timeline, everything its secondaries
+  // referenced is free to be recorded again.
+  try {
+
+    for (WorkerPool& pool : pools[currentFrame]) {
+      device.resetCommandPool(pool.commandPool);
+      pool.usedCommandBuffers = 0;
+    }
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while recording command pool reset: " << e.what();
+    return StatusCode::commandBufferRecordError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode ParallelRecorder::record(
+  ThreadPool& threadPool,
+  const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+  const std::vector<RecordCallback>& callbacks,
+  std::vector<vk::CommandBuffer>& secondaryCommandBuffers
+) {
+
+  secondaryCommandBuffers.resize(callbacks.size());
+
+  std::atomic<bool> failed{false};
+
+  threadPool.dispatch(static_cast<uint32_t>(callbacks.size()), [&](uint32_t task, uint32_t worker) {
+    try {
+
+      vk::CommandBuffer commandBuffer = nextCommandBuffer(pools[currentFrame][worker]);
+
+      vk::CommandBufferBeginInfo beginInfo(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+        &inheritanceInfo
+      );
+
+      commandBuffer.begin(beginInfo);
+      callbacks[task](commandBuffer);
+      commandBuffer.end();
+
+      secondaryCommandBuffers[task] = commandBuffer;
+
+    } catch (vk::SystemError& e) {
+      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while secondary command buffer record: " << e.what();
+      failed = true;
+    }
+  });
+
+  return failed ? StatusCode::commandBufferRecordError : StatusCode::success;
+}
+
+vk::CommandBuffer ParallelRecorder::nextCommandBuffer(WorkerPool& pool) {
+
+  if (pool.usedCommandBuffers == pool.commandBuffers.size()) {
+    vk::CommandBufferAllocateInfo allocInfo(
+      pool.commandPool,
+      vk::CommandBufferLevel::eSecondary,
+      1
+    );
+
+    pool.commandBuffers.push_back(device.allocateCommandBuffers(allocInfo).front());
+  }
+
+  return pool.commandBuffers[pool.usedCommandBuffers++];
+}
+
+} //namespace benpu
+
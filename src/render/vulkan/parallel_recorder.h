@@ -0,0 +1,52 @@
+#ifndef BENPU_PARALLEL_RECORDER_H_
+#define BENPU_PARALLEL_RECORDER_H_
+
+#include <functional>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/utils/thread_pool.h"
+#include "render/vulkan/queue.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Records secondary command buffers on the worker threads of a ThreadPool.
+// Every worker owns one command pool per frame in flight, so recording never
+// contends on a pool and a whole frame is recycled with a single pool reset.
+class ParallelRecorder {
+public:
+  using RecordCallback = std::function<void(vk::CommandBuffer)>;
+
+  ParallelRecorder(vk::Device& device);
+
+  StatusCode initialize(const QueueFamilyIndices& queueFamilyIndices, uint32_t framesInFlight, uint32_t workerCount);
+
+  StatusCode beginFrame(uint32_t frameIndex);
+  StatusCode record(
+    ThreadPool& threadPool,
+    const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+    const std::vector<RecordCallback>& callbacks,
+    std::vector<vk::CommandBuffer>& secondaryCommandBuffers
+  );
+
+private:
+  struct WorkerPool {
+    vk::CommandPool commandPool = nullptr;
+    std::vector<vk::CommandBuffer> commandBuffers;
+    uint32_t usedCommandBuffers = 0;
+  };
+
+  vk::Device& device;
+  // Indexed [frame][worker].
+  std::vector<std::vector<WorkerPool>> pools;
+  uint32_t currentFrame = 0;
+
+private:
+  vk::CommandBuffer nextCommandBuffer(WorkerPool& pool);
+};
+
+} //namespace benpu
+
+#endif
@@ -1,8 +1,7 @@
 
-#include <fstream>
-
 #include <boost/log/trivial.hpp>
 
+#include "core/utils/hash.h"
 #include "render/vulkan/pipeline.h"
 
 namespace benpu {
@@ -11,94 +10,127 @@ Pipeline::Pipeline(vk::Device& device): device{device} {
 
 }
 
-static StatusCode readFile(const std::string& filename, std::vector<char>& buffer) {
-  std::ifstream file(filename, std::ios::ate | std::ios::binary);
+bool operator==(const PipelineDescription& a, const PipelineDescription& b) {
+  return a.vertexShader == b.vertexShader
+    && a.fragmentShader == b.fragmentShader
+    && a.vertexLayout.bindings == b.vertexLayout.bindings
+    && a.vertexLayout.attributes == b.vertexLayout.attributes
+    && a.setLayouts == b.setLayouts
+    && a.pushConstantRanges == b.pushConstantRanges
+    && a.renderPass == b.renderPass
+    && a.colorFormats == b.colorFormats
+    && a.topology == b.topology
+    && a.cullMode == b.cullMode
+    && a.frontFace == b.frontFace
+    && a.blending == b.blending
+    && a.specializationConstants == b.specializationConstants;
+}
+
+size_t PipelineDescriptionHash::operator()(const PipelineDescription& description) const {
 
-  if (!file.is_open()) {
-    return StatusCode::fileCouldntBeOpened;
+  size_t seed = 0;
+
+  hashCombine(seed, description.vertexShader);
+  hashCombine(seed, description.fragmentShader);
+
+  for (const vk::VertexInputBindingDescription& binding : description.vertexLayout.bindings) {
+    hashCombine(seed, binding.binding);
+    hashCombine(seed, binding.stride);
+    hashCombine(seed, binding.inputRate);
   }
 
-  size_t fileSize = (size_t) file.tellg();
-  buffer.resize(fileSize);
-  file.seekg(0);
-  file.read(buffer.data(), fileSize);
-  file.close();
+  for (const vk::VertexInputAttributeDescription& attribute : description.vertexLayout.attributes) {
+    hashCombine(seed, attribute.location);
+    hashCombine(seed, attribute.binding);
+    hashCombine(seed, attribute.format);
+    hashCombine(seed, attribute.offset);
+  }
 
-  return StatusCode::success;
-}
+  for (vk::DescriptorSetLayout setLayout : description.setLayouts) {
+    hashCombine(seed, static_cast<VkDescriptorSetLayout>(setLayout));
+  }
 
-StatusCode Pipeline::createShaderModule(const std::vector<char>& code, vk::ShaderModule& shaderModule) {
-  try {
+  for (const vk::PushConstantRange& range : description.pushConstantRanges) {
+    hashCombine(seed, static_cast<VkShaderStageFlags>(range.stageFlags));
+    hashCombine(seed, range.offset);
+    hashCombine(seed, range.size);
+  }
 
-    vk::ShaderModuleCreateInfo createInfo(
-      {},
-      code.size(),
-      reinterpret_cast<const uint32_t*>(code.data())
-    );
+  hashCombine(seed, static_cast<VkRenderPass>(description.renderPass));
+
+  for (vk::Format format : description.colorFormats) {
+    hashCombine(seed, format);
+  }
 
-    shaderModule = device.createShaderModule(createInfo);
+  hashCombine(seed, description.topology);
+  hashCombine(seed, static_cast<VkCullModeFlags>(description.cullMode));
+  hashCombine(seed, description.frontFace);
+  hashCombine(seed, description.blending);
 
-  } catch(vk::SystemError& e) {
-    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while shader module creation: " << e.what();
-    return StatusCode::shaderModuleCreationError;
+  for (const SpecializationConstant& constant : description.specializationConstants) {
+    hashCombine(seed, constant.id);
+    hashCombine(seed, constant.value);
   }
 
-  return StatusCode::success;
+  return seed;
 }
 
-StatusCode Pipeline::initialize() {
+StatusCode Pipeline::initialize(const PipelineDescription& description, const PipelineResources& resources, vk::PipelineCache pipelineCache) {
 
-  BOOST_LOG_TRIVIAL(info) << "Creating graphics pipeline.";
+  BOOST_LOG_TRIVIAL(info) << "Creating graphics pipeline for " << description.vertexShader << " and " << description.fragmentShader << ".";
 
-  std::vector<char> vertexShaderCode;
-  if (readFile("shaders/first.vert.spv", vertexShaderCode) != StatusCode::success) {
-    BOOST_LOG_TRIVIAL(error) << "Couldn't open vertex shader.";
-    return StatusCode::graphicsPipelineCreationError;
-  }
+  pipelineLayout = resources.layout;
 
-  std::vector<char> fragmentShaderCode;
-  if (readFile("shaders/first.frag.spv", fragmentShaderCode) != StatusCode::success) {
-    BOOST_LOG_TRIVIAL(error) << "Couldn't open fragment shader.";
-    return StatusCode::graphicsPipelineCreationError;
-  }
+  std::vector<vk::SpecializationMapEntry> specializationEntries;
+  std::vector<uint32_t> specializationData;
 
-  if (createShaderModule(vertexShaderCode, vertexShaderModule) != StatusCode::success) {
-    BOOST_LOG_TRIVIAL(error) << "Couldn't create vertex shader module.";
-    return StatusCode::graphicsPipelineCreationError;
+  for (const SpecializationConstant& constant : description.specializationConstants) {
+    specializationEntries.emplace_back(
+      constant.id,
+      static_cast<uint32_t>(specializationData.size() * sizeof(uint32_t)),
+      sizeof(uint32_t)
+    );
+    specializationData.push_back(constant.value);
   }
 
-  if (createShaderModule(fragmentShaderCode, fragmentShaderModule) != StatusCode::success) {
-    BOOST_LOG_TRIVIAL(error) << "Couldn't create fragment shader module.";
-    return StatusCode::graphicsPipelineCreationError;
-  }
+  vk::SpecializationInfo specializationInfo(
+    static_cast<uint32_t>(specializationEntries.size()),
+    specializationEntries.data(),
+    specializationData.size() * sizeof(uint32_t),
+    specializationData.data()
+  );
+
+  const vk::SpecializationInfo* specialization = specializationEntries.empty() ? nullptr : &specializationInfo;
 
   try {
     vk::PipelineShaderStageCreateInfo shaderStages[] = {
       vk::PipelineShaderStageCreateInfo(
         {},
         vk::ShaderStageFlagBits::eVertex,
-        vertexShaderModule,
-        "main"
+        resources.vertexShader,
+        "main",
+        specialization
       ), 
       vk::PipelineShaderStageCreateInfo(
         {},
         vk::ShaderStageFlagBits::eFragment,
-        fragmentShaderModule,
-        "main"
+        resources.fragmentShader,
+        "main",
+        specialization
       )
     };
 
     vk::PipelineVertexInputStateCreateInfo vertInputInfo(
       {},
-      0,
-      nullptr,
-      0,
-      nullptr
+      static_cast<uint32_t>(description.vertexLayout.bindings.size()),
+      description.vertexLayout.bindings.data(),
+      static_cast<uint32_t>(description.vertexLayout.attributes.size()),
+      description.vertexLayout.attributes.data()
     );
 
     vk::PipelineInputAssemblyStateCreateInfo inputAssembly(
       {},
-      vk::PrimitiveTopology::eTriangleList,
+      description.topology,
       vk::False
     );
 
@@ -115,8 +147,8 @@ StatusCode Pipeline::initialize() {
       vk::False,
       vk::False,
       vk::PolygonMode::eFill,
-      vk::CullModeFlagBits::eBack,      
-      vk::FrontFace::eClockwise,
+      description.cullMode,
+      description.frontFace,
       vk::False,
       {},
       {},
@@ -131,7 +163,7 @@ StatusCode Pipeline::initialize() {
     );
 
     vk::PipelineColorBlendAttachmentState colorBlendAttachment(
-      vk::True,
+      description.blending ? vk::True : vk::False,
       vk::BlendFactor::eSrcAlpha,
       vk::BlendFactor::eOneMinusSrcAlpha,
       vk::BlendOp::eAdd,
@@ -141,12 +173,18 @@ StatusCode Pipeline::initialize() {
       vk::ColorComponentFlagBits::eR |vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA
     );
 
+    // Every attachment shares the same blend state.
+    std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachments(
+      description.renderPass ? 1 : description.colorFormats.size(),
+      colorBlendAttachment
+    );
+
     vk::PipelineColorBlendStateCreateInfo colorBlending(
       {},
       vk::False,
       vk::LogicOp::eCopy,
-      1,
-      &colorBlendAttachment,
+      static_cast<uint32_t>(colorBlendAttachments.size()),
+      colorBlendAttachments.data(),
       {0.0f, 0.0f, 0.0f, 0.0f}
     );
 
@@ -162,20 +200,11 @@ StatusCode Pipeline::initialize() {
       dynamicStates.data()
     );
     
-    vk::PipelineLayoutCreateInfo pipelineLayoutInfo(
-      {},
+    vk::PipelineRenderingCreateInfo renderingInfo(
       0,
-      nullptr,
-      0,
-      nullptr
+      description.colorFormats
     );
 
-
-    if (device.createPipelineLayout(&pipelineLayoutInfo, nullptr, &pipelineLayout) != vk::Result::eSuccess) {
-      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while pipeline layout creation.";
-      return StatusCode::shaderModuleCreationError;
-    }
-
     vk::GraphicsPipelineCreateInfo createInfo(
       {},
       2,
@@ -190,12 +219,14 @@ StatusCode Pipeline::initialize() {
       &colorBlending,
       &dynamicState,
       pipelineLayout,
-      renderPass,
+      description.renderPass,
       0,
-      nullptr
+      nullptr,
+      0,
+      description.renderPass ? nullptr : &renderingInfo
     );
 
-    auto [resultPipelineCreation, pipeline] = device.createGraphicsPipeline(nullptr, createInfo);
+    auto [resultPipelineCreation, pipeline] = device.createGraphicsPipeline(pipelineCache, createInfo);
     graphicsPipeline = pipeline;
 
     if (resultPipelineCreation != vk::Result::eSuccess) {
@@ -212,4 +243,12 @@ StatusCode Pipeline::initialize() {
 
   }
 
+vk::Pipeline Pipeline::getPipeline() const {
+  return graphicsPipeline;
+}
+
+vk::PipelineLayout Pipeline::getPipelineLayout() const {
+  return pipelineLayout;
+}
+
 } //namespace benpu
\ No newline at end of file
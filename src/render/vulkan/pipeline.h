@@ -1,31 +1,82 @@
 #ifndef BENPU_PIPELINE_H_
 #define BENPU_PIPELINE_H_
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <vulkan/vulkan.hpp>
 
+#include "render/vulkan/vertex.h"
 #include "status_code.h"
 
 namespace benpu {
 
+// Value for a constant_id in the shaders. Every scalar specialization
+// constant is 32 bits wide, bools are 0 or 1 and floats go in as their bits.
+struct SpecializationConstant {
+  uint32_t id;
+  uint32_t value;
+
+  static SpecializationConstant fromFloat(uint32_t id, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return {id, bits};
+  }
+
+  bool operator==(const SpecializationConstant& other) const { return id == other.id && value == other.value; }
+};
+
+// Everything needed to build a graphics pipeline. Either renderPass is set
+// or, with dynamic rendering, colorFormats describes the attachments.
+struct PipelineDescription {
+  // Names of the embedded SPIR-V, e.g. "first.vert.spv".
+  std::string vertexShader;
+  std::string fragmentShader;
+  VertexLayout vertexLayout;
+  // Null sets, and the ranges when empty, are derived from the shaders.
+  std::vector<vk::DescriptorSetLayout> setLayouts;
+  std::vector<vk::PushConstantRange> pushConstantRanges;
+  vk::RenderPass renderPass = nullptr;
+  std::vector<vk::Format> colorFormats;
+  vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+  vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+  vk::FrontFace frontFace = vk::FrontFace::eClockwise;
+  bool blending = true;
+  // Applied to both stages, a stage ignores ids it doesn't declare. Each
+  // distinct set of values is its own pipeline variant.
+  std::vector<SpecializationConstant> specializationConstants;
+};
+
+bool operator==(const PipelineDescription& a, const PipelineDescription& b);
+
+struct PipelineDescriptionHash {
+  size_t operator()(const PipelineDescription& description) const;
+};
+
+// Shared objects a pipeline is built from, owned by the PipelineRegistry.
+struct PipelineResources {
+  vk::ShaderModule vertexShader = nullptr;
+  vk::ShaderModule fragmentShader = nullptr;
+  vk::PipelineLayout layout = nullptr;
+};
+
 class Pipeline {
 public:
 
   Pipeline(vk::Device& device);
   
-  StatusCode initialize();
+  StatusCode initialize(const PipelineDescription& description, const PipelineResources& resources, vk::PipelineCache pipelineCache);
+  vk::Pipeline getPipeline() const;
+  vk::PipelineLayout getPipelineLayout() const;
 
 private:
   vk::Device& device;
-  vk::ShaderModule fragmentShaderModule = nullptr;
-  vk::ShaderModule vertexShaderModule = nullptr;
   vk::PipelineLayout pipelineLayout = nullptr;
-  vk::RenderPass renderPass = nullptr;
   vk::Pipeline graphicsPipeline = nullptr;
-
-private:
-  StatusCode createShaderModule(const std::vector<char>& code, vk::ShaderModule& shaderModule);
 };
 
 } //namespace benpu
 
-#endif
\ No newline at end of file
+#endif
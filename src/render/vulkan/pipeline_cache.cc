@@ -0,0 +1,166 @@
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/pipeline_cache.h"
+
+namespace benpu {
+
+static constexpr uint32_t cacheFileMagic = 0x43505042; // "BPPC"
+static constexpr uint32_t cacheFileVersion = 1;
+
+struct CacheFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t vendorID;
+  uint32_t deviceID;
+  uint32_t driverVersion;
+  uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+  uint32_t reserved;
+  uint64_t dataSize;
+};
+
+static CacheFileHeader makeHeader(const vk::PhysicalDeviceProperties& properties, uint64_t dataSize) {
+
+  CacheFileHeader header{};
+  header.magic = cacheFileMagic;
+  header.version = cacheFileVersion;
+  header.vendorID = properties.vendorID;
+  header.deviceID = properties.deviceID;
+  header.driverVersion = properties.driverVersion;
+  std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+  header.dataSize = dataSize;
+
+  return header;
+}
+
+static bool readCacheFile(const std::filesystem::path& path, const vk::PhysicalDeviceProperties& properties, std::vector<char>& data) {
+
+  std::ifstream file(path, std::ios::binary);
+
+  if (!file.is_open()) {
+    return false;
+  }
+
+  CacheFileHeader header;
+
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    BOOST_LOG_TRIVIAL(warning) << "Pipeline cache file is truncated.";
+    return false;
+  }
+
+  CacheFileHeader expected = makeHeader(properties, header.dataSize);
+
+  if (std::memcmp(&header, &expected, sizeof(header)) != 0) {
+    BOOST_LOG_TRIVIAL(info) << "Pipeline cache was built by another device or driver, discarding it.";
+    return false;
+  }
+
+  data.resize(static_cast<size_t>(header.dataSize));
+
+  if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+    BOOST_LOG_TRIVIAL(warning) << "Pipeline cache file is truncated.";
+    data.clear();
+    return false;
+  }
+
+  return true;
+}
+
+PipelineCache::PipelineCache(vk::Device& device): device{device} {
+
+}
+
+StatusCode PipelineCache::initialize(vk::PhysicalDevice physicalDevice, const std::filesystem::path& path) {
+
+  this->path = path;
+  properties = physicalDevice.getProperties();
+
+  std::vector<char> data;
+
+  if (readCacheFile(path, properties, data)) {
+    BOOST_LOG_TRIVIAL(info) << "Loaded " << data.size() << " bytes of pipeline cache from " << path << ".";
+  }
+
+  savedSize = data.size();
+
+  vk::PipelineCacheCreateInfo cacheInfo(
+    {},
+    data.size(),
+    data.data()
+  );
+
+  try {
+
+    pipelineCache = device.createPipelineCache(cacheInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while pipeline cache creation: " << e.what();
+    return StatusCode::pipelineCacheError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode PipelineCache::save() {
+
+  std::vector<uint8_t> data;
+
+  try {
+
+    data = device.getPipelineCacheData(pipelineCache);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while reading pipeline cache: " << e.what();
+    return StatusCode::pipelineCacheError;
+  }
+
+  // Caches only ever grow, an unchanged size means nothing new was
+  // compiled since the last save.
+  if (data.size() == savedSize) {
+    return StatusCode::success;
+  }
+
+  std::filesystem::path temporaryPath = path;
+  temporaryPath += ".tmp";
+
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    CacheFileHeader header = makeHeader(properties, data.size());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    if (!file) {
+      BOOST_LOG_TRIVIAL(warning) << "Couldn't write pipeline cache to " << temporaryPath << ".";
+      std::filesystem::remove(temporaryPath, error);
+      return StatusCode::pipelineCacheError;
+    }
+  }
+
+  std::filesystem::rename(temporaryPath, path, error);
+
+  if (error) {
+    BOOST_LOG_TRIVIAL(warning) << "Couldn't replace pipeline cache " << path << ": " << error.message();
+    std::filesystem::remove(temporaryPath, error);
+    return StatusCode::pipelineCacheError;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "Saved " << data.size() << " bytes of pipeline cache.";
+
+  savedSize = data.size();
+
+  return StatusCode::success;
+}
+
+vk::PipelineCache PipelineCache::getPipelineCache() const {
+  return pipelineCache;
+}
+
+} //namespace benpu
@@ -0,0 +1,37 @@
+#ifndef BENPU_PIPELINE_CACHE_H_
+#define BENPU_PIPELINE_CACHE_H_
+
+#include <cstddef>
+#include <filesystem>
+
+#include <vulkan/vulkan.hpp>
+
+#include "status_code.h"
+
+namespace benpu {
+
+// vk::PipelineCache persisted across launches. The file is prefixed with
+// the vendor, device, driver version and pipelineCacheUUID it was built
+// with and is discarded on any mismatch, so a driver update never feeds
+// stale binaries to the driver. Saves go through a temporary file and a
+// rename so a crash can't leave a truncated cache behind.
+class PipelineCache {
+public:
+  PipelineCache(vk::Device& device);
+
+  StatusCode initialize(vk::PhysicalDevice physicalDevice, const std::filesystem::path& path);
+  StatusCode save();
+
+  vk::PipelineCache getPipelineCache() const;
+
+private:
+  vk::Device& device;
+  vk::PhysicalDeviceProperties properties;
+  std::filesystem::path path;
+  vk::PipelineCache pipelineCache = nullptr;
+  size_t savedSize = 0;
+};
+
+} //namespace benpu
+
+#endif
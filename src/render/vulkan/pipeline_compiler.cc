@@ -0,0 +1,55 @@
+
+#include <chrono>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/pipeline_compiler.h"
+
+namespace benpu {
+
+PipelineCompiler::PipelineCompiler(vk::Device& device): device{device} {
+
+}
+
+StatusCode PipelineCompiler::initialize(uint32_t threadCount, vk::PipelineCache pipelineCache) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating pipeline compiler with " << threadCount << " threads.";
+
+  this->pipelineCache = pipelineCache;
+  threadPool = std::make_unique<ThreadPool>(threadCount);
+
+  return StatusCode::success;
+}
+
+PipelineFuture PipelineCompiler::compile(const PipelineDescription& description, const PipelineResources& resources) {
+
+  auto promise = std::make_shared<std::promise<std::shared_ptr<Pipeline>>>();
+  PipelineFuture future = promise->get_future().share();
+
+  // The pipeline cache is internally synchronized, workers share it.
+  threadPool->submit([this, promise, description, resources](uint32_t) {
+    auto pipeline = std::make_shared<Pipeline>(device);
+
+    if (pipeline->initialize(description, resources, pipelineCache) != StatusCode::success) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't compile pipeline for " << description.vertexShader << " and " << description.fragmentShader << ".";
+      pipeline = nullptr;
+    }
+
+    promise->set_value(pipeline);
+  });
+
+  return future;
+}
+
+std::shared_ptr<Pipeline> PipelineCompiler::resolve(const PipelineFuture& future, std::shared_ptr<Pipeline> fallback) {
+
+  if (!future.valid() || future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return fallback;
+  }
+
+  std::shared_ptr<Pipeline> pipeline = future.get();
+
+  return pipeline ? pipeline : fallback;
+}
+
+} //namespace benpu
@@ -0,0 +1,41 @@
+#ifndef BENPU_PIPELINE_COMPILER_H_
+#define BENPU_PIPELINE_COMPILER_H_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/utils/thread_pool.h"
+#include "render/vulkan/pipeline.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Null once resolved if the compilation failed.
+using PipelineFuture = std::shared_future<std::shared_ptr<Pipeline>>;
+
+// Builds pipelines on its own worker threads, so a compile never delays
+// command recording, which runs on the recording pool. Callers keep the
+// future and resolve it every frame; until it is ready they skip the draw
+// or use a fallback pipeline.
+class PipelineCompiler {
+public:
+  PipelineCompiler(vk::Device& device);
+
+  StatusCode initialize(uint32_t threadCount, vk::PipelineCache pipelineCache);
+
+  PipelineFuture compile(const PipelineDescription& description, const PipelineResources& resources);
+
+  static std::shared_ptr<Pipeline> resolve(const PipelineFuture& future, std::shared_ptr<Pipeline> fallback = nullptr);
+
+private:
+  vk::Device& device;
+  vk::PipelineCache pipelineCache = nullptr;
+  std::unique_ptr<ThreadPool> threadPool;
+};
+
+} //namespace benpu
+
+#endif
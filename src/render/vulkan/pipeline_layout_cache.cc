@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <map>
+
+#include <boost/log/trivial.hpp>
+
+#include "core/utils/hash.h"
+#include "render/vulkan/pipeline_layout_cache.h"
+
+namespace benpu {
+
+static vk::ShaderStageFlags getStageFlags(SpirvReflection::Stage stage) {
+  switch (stage) {
+    case SpirvReflection::Stage::vertex: return vk::ShaderStageFlagBits::eVertex;
+    case SpirvReflection::Stage::fragment: return vk::ShaderStageFlagBits::eFragment;
+    case SpirvReflection::Stage::compute: return vk::ShaderStageFlagBits::eCompute;
+    default: return vk::ShaderStageFlagBits::eAll;
+  }
+}
+
+static vk::DescriptorType getDescriptorType(SpirvReflection::DescriptorKind kind) {
+  switch (kind) {
+    case SpirvReflection::DescriptorKind::sampler: return vk::DescriptorType::eSampler;
+    case SpirvReflection::DescriptorKind::combinedImageSampler: return vk::DescriptorType::eCombinedImageSampler;
+    case SpirvReflection::DescriptorKind::sampledImage: return vk::DescriptorType::eSampledImage;
+    case SpirvReflection::DescriptorKind::storageImage: return vk::DescriptorType::eStorageImage;
+    case SpirvReflection::DescriptorKind::uniformTexelBuffer: return vk::DescriptorType::eUniformTexelBuffer;
+    case SpirvReflection::DescriptorKind::storageTexelBuffer: return vk::DescriptorType::eStorageTexelBuffer;
+    case SpirvReflection::DescriptorKind::uniformBuffer: return vk::DescriptorType::eUniformBuffer;
+    default: return vk::DescriptorType::eStorageBuffer;
+  }
+}
+
+bool PipelineLayoutCache::PipelineLayoutKey::operator==(const PipelineLayoutKey& other) const {
+  return setLayouts == other.setLayouts && pushConstantRanges == other.pushConstantRanges;
+}
+
+size_t PipelineLayoutCache::PipelineLayoutKeyHash::operator()(const PipelineLayoutKey& key) const {
+
+  size_t seed = 0;
+
+  for (vk::DescriptorSetLayout setLayout : key.setLayouts) {
+    hashCombine(seed, static_cast<VkDescriptorSetLayout>(setLayout));
+  }
+
+  for (const vk::PushConstantRange& range : key.pushConstantRanges) {
+    hashCombine(seed, static_cast<VkShaderStageFlags>(range.stageFlags));
+    hashCombine(seed, range.offset);
+    hashCombine(seed, range.size);
+  }
+
+  return seed;
+}
+
+size_t PipelineLayoutCache::BindingsHash::operator()(const std::vector<vk::DescriptorSetLayoutBinding>& bindings) const {
+
+  size_t seed = 0;
+
+  for (const vk::DescriptorSetLayoutBinding& binding : bindings) {
+    hashCombine(seed, binding.binding);
+    hashCombine(seed, binding.descriptorType);
+    hashCombine(seed, binding.descriptorCount);
+    hashCombine(seed, static_cast<VkShaderStageFlags>(binding.stageFlags));
+  }
+
+  return seed;
+}
+
+PipelineLayoutCache::PipelineLayoutCache(vk::Device& device): device{device} {
+
+}
+
+StatusCode PipelineLayoutCache::getPipelineLayout(
+  const std::vector<const SpirvReflection*>& stages,
+  const std::vector<vk::DescriptorSetLayout>& setLayouts,
+  const std::vector<vk::PushConstantRange>& pushConstantRanges,
+  vk::PipelineLayout& layout
+) {
+
+  //Bindings per set, merged across stages.
+  std::map<uint32_t, std::map<uint32_t, vk::DescriptorSetLayoutBinding>> sets;
+  //Same shape as UniformRing::setConstants pushes, every stage from offset 0.
+  vk::PushConstantRange pushConstants(vk::ShaderStageFlagBits::eAll, 0, 0);
+
+  for (const SpirvReflection* stage : stages) {
+    vk::ShaderStageFlags stageFlags = getStageFlags(stage->stage);
+
+    for (const SpirvReflection::Binding& binding : stage->bindings) {
+      vk::DescriptorSetLayoutBinding& merged = sets[binding.set][binding.binding];
+      merged.binding = binding.binding;
+      merged.descriptorType = getDescriptorType(binding.kind);
+      merged.descriptorCount = std::max(merged.descriptorCount, binding.count);
+      merged.stageFlags |= stageFlags;
+
+      //The bound of a runtime array is only known to whoever owns the
+      //table, those sets have to be given explicitly.
+      if (binding.count == 0 && (binding.set >= setLayouts.size() || !setLayouts[binding.set])) {
+        BOOST_LOG_TRIVIAL(error) << "Set " << binding.set << " has a runtime sized array, its layout can't be derived.";
+        return StatusCode::descriptorCreationError;
+      }
+    }
+
+    pushConstants.size = std::max(pushConstants.size, stage->pushConstantOffset + stage->pushConstantSize);
+  }
+
+  PipelineLayoutKey key;
+  key.setLayouts = setLayouts;
+  key.pushConstantRanges = pushConstantRanges;
+
+  if (!sets.empty() && sets.rbegin()->first >= key.setLayouts.size()) {
+    key.setLayouts.resize(sets.rbegin()->first + 1);
+  }
+
+  //Sets in between the used ones still need a (possibly empty) layout.
+  for (uint32_t set = 0; set < key.setLayouts.size(); ++set) {
+    if (key.setLayouts[set]) {
+      continue;
+    }
+
+    std::vector<vk::DescriptorSetLayoutBinding> bindings;
+
+    for (const auto& [index, binding] : sets[set]) {
+      bindings.push_back(binding);
+    }
+
+    if (getDescriptorSetLayout(bindings, key.setLayouts[set]) != StatusCode::success) {
+      return StatusCode::descriptorCreationError;
+    }
+  }
+
+  if (key.pushConstantRanges.empty() && pushConstants.size > 0) {
+    key.pushConstantRanges.push_back(pushConstants);
+  }
+
+  auto found = pipelineLayouts.find(key);
+
+  if (found != pipelineLayouts.end()) {
+    layout = found->second;
+    return StatusCode::success;
+  }
+
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo(
+    {},
+    key.setLayouts,
+    key.pushConstantRanges
+  );
+
+  try {
+
+    layout = device.createPipelineLayout(pipelineLayoutInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while pipeline layout creation: " << e.what();
+    return StatusCode::graphicsPipelineCreationError;
+  }
+
+  pipelineLayouts.emplace(std::move(key), layout);
+
+  return StatusCode::success;
+}
+
+StatusCode PipelineLayoutCache::getDescriptorSetLayout(const std::vector<vk::DescriptorSetLayoutBinding>& bindings, vk::DescriptorSetLayout& layout) {
+
+  auto found = descriptorSetLayouts.find(bindings);
+
+  if (found != descriptorSetLayouts.end()) {
+    layout = found->second;
+    return StatusCode::success;
+  }
+
+  try {
+
+    layout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({}, bindings));
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while descriptor set layout creation: " << e.what();
+    return StatusCode::descriptorCreationError;
+  }
+
+  descriptorSetLayouts.emplace(bindings, layout);
+
+  return StatusCode::success;
+}
+
+} //namespace benpu
@@ -0,0 +1,62 @@
+#ifndef BENPU_PIPELINE_LAYOUT_CACHE_H_
+#define BENPU_PIPELINE_LAYOUT_CACHE_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/utils/spirv_reflection.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Descriptor set and pipeline layouts derived from shader reflection. Equal
+// layouts are created once, so pipelines whose shaders declare the same
+// interface share them and switching between them keeps bound sets valid.
+// Not synchronized, the PipelineRegistry calls it under its lock.
+class PipelineLayoutCache {
+public:
+  PipelineLayoutCache(vk::Device& device);
+
+  // Non null entries of setLayouts are used as given, they are the global
+  // tables whose flags (update after bind, dynamic offsets) reflection
+  // can't see. The other sets are derived from the bindings the stages
+  // declare. Without push constant ranges a single one is derived,
+  // visible to every stage from offset 0 the way UniformRing pushes.
+  StatusCode getPipelineLayout(
+    const std::vector<const SpirvReflection*>& stages,
+    const std::vector<vk::DescriptorSetLayout>& setLayouts,
+    const std::vector<vk::PushConstantRange>& pushConstantRanges,
+    vk::PipelineLayout& layout
+  );
+
+  StatusCode getDescriptorSetLayout(const std::vector<vk::DescriptorSetLayoutBinding>& bindings, vk::DescriptorSetLayout& layout);
+
+  size_t getDescriptorSetLayoutCount() const { return descriptorSetLayouts.size(); }
+  size_t getPipelineLayoutCount() const { return pipelineLayouts.size(); }
+
+private:
+  struct PipelineLayoutKey {
+    std::vector<vk::DescriptorSetLayout> setLayouts;
+    std::vector<vk::PushConstantRange> pushConstantRanges;
+
+    bool operator==(const PipelineLayoutKey& other) const;
+  };
+
+  struct PipelineLayoutKeyHash {
+    size_t operator()(const PipelineLayoutKey& key) const;
+  };
+
+  struct BindingsHash {
+    size_t operator()(const std::vector<vk::DescriptorSetLayoutBinding>& bindings) const;
+  };
+
+  vk::Device& device;
+  std::unordered_map<std::vector<vk::DescriptorSetLayoutBinding>, vk::DescriptorSetLayout, BindingsHash> descriptorSetLayouts;
+  std::unordered_map<PipelineLayoutKey, vk::PipelineLayout, PipelineLayoutKeyHash> pipelineLayouts;
+};
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,202 @@
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/embedded_shaders.h"
+#include "render/vulkan/pipeline_registry.h"
+
+namespace benpu {
+
+PipelineRegistry::PipelineRegistry(vk::Device& device, PipelineCompiler& compiler): device{device}, compiler{compiler}, layoutCache(device) {
+
+}
+
+PipelineFuture PipelineRegistry::get(const PipelineDescription& requested) {
+
+  //Constants in any order select the same variant.
+  PipelineDescription description = requested;
+  std::stable_sort(
+    description.specializationConstants.begin(),
+    description.specializationConstants.end(),
+    [](const SpecializationConstant& a, const SpecializationConstant& b) { return a.id < b.id; }
+  );
+
+  //Vulkan doesn't allow an id twice in one VkSpecializationInfo.
+  auto duplicate = std::adjacent_find(
+    description.specializationConstants.begin(),
+    description.specializationConstants.end(),
+    [](const SpecializationConstant& a, const SpecializationConstant& b) { return a.id == b.id; }
+  );
+
+  if (duplicate != description.specializationConstants.end()) {
+    BOOST_LOG_TRIVIAL(error) << "Specialization constant " << duplicate->id << " is given more than once for pipeline of " << description.vertexShader << " and " << description.fragmentShader << ".";
+    return PipelineFuture();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto found = pipelines.find(description);
+
+  if (found != pipelines.end()) {
+    return found->second;
+  }
+
+  PipelineResources resources;
+
+  if (getShaderModule(description.vertexShader, resources.vertexShader) != StatusCode::success
+    || getShaderModule(description.fragmentShader, resources.fragmentShader) != StatusCode::success
+    || getLayout(description, resources.layout) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create resources for pipeline of " << description.vertexShader << " and " << description.fragmentShader << ".";
+    return PipelineFuture();
+  }
+
+  PipelineFuture future = compiler.compile(description, resources);
+  pipelines.emplace(description, future);
+
+  return future;
+}
+
+StatusCode PipelineRegistry::reload(const std::string& shader, const std::vector<uint32_t>& code, Timeline& timeline) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  vk::ShaderModule shaderModule;
+
+  if (createShaderModule(shader, code.data(), code.size() * sizeof(uint32_t), shaderModule) != StatusCode::success) {
+    return StatusCode::shaderModuleCreationError;
+  }
+
+  auto found = shaderModules.find(shader);
+
+  //No pipeline uses it yet, later ones pick up the new code.
+  if (found == shaderModules.end()) {
+    shaderModules.emplace(shader, shaderModule);
+    return StatusCode::success;
+  }
+
+  vk::ShaderModule previous = found->second;
+  found->second = shaderModule;
+
+  std::vector<PipelineFuture> replaced;
+
+  for (auto& [description, future] : pipelines) {
+    if (description.vertexShader != shader && description.fragmentShader != shader) {
+      continue;
+    }
+
+    replaced.push_back(future);
+
+    PipelineResources resources;
+
+    if (getShaderModule(description.vertexShader, resources.vertexShader) != StatusCode::success
+      || getShaderModule(description.fragmentShader, resources.fragmentShader) != StatusCode::success
+      || getLayout(description, resources.layout) != StatusCode::success) {
+      continue;
+    }
+
+    future = compiler.compile(description, resources);
+  }
+
+  //Compiles still running on the old module must finish before it goes.
+  timeline.retire(timeline.getLastSubmittedValue(), [this, previous, replaced]() {
+    for (const PipelineFuture& future : replaced) {
+      future.wait();
+    }
+    device.destroyShaderModule(previous);
+  });
+
+  return StatusCode::success;
+}
+
+size_t PipelineRegistry::getPipelineCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return pipelines.size();
+}
+
+StatusCode PipelineRegistry::getShaderModule(const std::string& name, vk::ShaderModule& shaderModule) {
+
+  auto found = shaderModules.find(name);
+
+  if (found != shaderModules.end()) {
+    shaderModule = found->second;
+    return StatusCode::success;
+  }
+
+  const EmbeddedShader* shader = findEmbeddedShader(name);
+
+  if (!shader) {
+    BOOST_LOG_TRIVIAL(error) << "Shader " << name << " isn't embedded in the binary.";
+    return StatusCode::shaderModuleCreationError;
+  }
+
+  if (createShaderModule(name, shader->code, shader->size, shaderModule) != StatusCode::success) {
+    return StatusCode::shaderModuleCreationError;
+  }
+
+  shaderModules.emplace(name, shaderModule);
+
+  return StatusCode::success;
+}
+
+StatusCode PipelineRegistry::createShaderModule(const std::string& name, const uint32_t* code, size_t size, vk::ShaderModule& shaderModule) {
+
+  std::optional<SpirvReflection> reflection = reflectSpirv(code, size / sizeof(uint32_t));
+
+  if (!reflection) {
+    BOOST_LOG_TRIVIAL(error) << "Shader " << name << " isn't valid SPIR-V.";
+    return StatusCode::shaderModuleCreationError;
+  }
+
+  try {
+
+    vk::ShaderModuleCreateInfo createInfo(
+      {},
+      size,
+      code
+    );
+
+    shaderModule = device.createShaderModule(createInfo);
+
+  } catch(vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while shader module creation: " << e.what();
+    return StatusCode::shaderModuleCreationError;
+  }
+
+  reflections[name] = std::move(*reflection);
+
+  return StatusCode::success;
+}
+
+StatusCode PipelineRegistry::getLayout(const PipelineDescription& description, vk::PipelineLayout& layout) {
+
+  const SpirvReflection& vertex = reflections.at(description.vertexShader);
+  const SpirvReflection& fragment = reflections.at(description.fragmentShader);
+
+  //Attributes are laid out by the description, reflection only tells
+  //whether it feeds every input the shader reads.
+  for (const SpirvReflection::VertexInput& input : vertex.vertexInputs) {
+    auto attribute = std::find_if(
+      description.vertexLayout.attributes.begin(),
+      description.vertexLayout.attributes.end(),
+      [&input](const vk::VertexInputAttributeDescription& candidate) { return candidate.location == input.location; }
+    );
+
+    if (attribute == description.vertexLayout.attributes.end()) {
+      BOOST_LOG_TRIVIAL(warning) << "Shader " << description.vertexShader << " reads location " << input.location << " the vertex layout doesn't provide.";
+    }
+  }
+
+  //Likely a typo in the id, the value would be silently ignored.
+  for (const SpecializationConstant& constant : description.specializationConstants) {
+    bool declared = std::binary_search(vertex.specializationIds.begin(), vertex.specializationIds.end(), constant.id)
+      || std::binary_search(fragment.specializationIds.begin(), fragment.specializationIds.end(), constant.id);
+
+    if (!declared) {
+      BOOST_LOG_TRIVIAL(warning) << "No stage of " << description.vertexShader << " and " << description.fragmentShader << " declares constant_id " << constant.id << ".";
+    }
+  }
+
+  return layoutCache.getPipelineLayout({&vertex, &fragment}, description.setLayouts, description.pushConstantRanges, layout);
+}
+
+} //namespace benpu
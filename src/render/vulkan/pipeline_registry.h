@@ -0,0 +1,59 @@
+#ifndef BENPU_PIPELINE_REGISTRY_H_
+#define BENPU_PIPELINE_REGISTRY_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "render/vulkan/pipeline.h"
+#include "core/utils/spirv_reflection.h"
+#include "render/vulkan/pipeline_compiler.h"
+#include "render/vulkan/pipeline_layout_cache.h"
+#include "render/vulkan/timeline.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Single entry point for graphics pipelines. Descriptions are hashed over
+// their full state and identical requests get the same pipeline, which is
+// compiled once. Shader modules, created from the SPIR-V embedded in the
+// binary, are shared by every pipeline that uses them, and the shaders are
+// reflected to derive layouts the description leaves out.
+class PipelineRegistry {
+public:
+  PipelineRegistry(vk::Device& device, PipelineCompiler& compiler);
+
+  // Each set of specialization constants is compiled and cached as its own
+  // variant. A set giving the same id twice is rejected with an empty
+  // future.
+  PipelineFuture get(const PipelineDescription& requested);
+
+  // Replaces a shader module with new SPIR-V and recompiles every pipeline
+  // using it, get() returns the new futures afterwards. The old module is
+  // retired on the timeline.
+  StatusCode reload(const std::string& shader, const std::vector<uint32_t>& code, Timeline& timeline);
+
+  size_t getPipelineCount() const;
+
+private:
+  vk::Device& device;
+  PipelineCompiler& compiler;
+  std::unordered_map<PipelineDescription, PipelineFuture, PipelineDescriptionHash> pipelines;
+  PipelineLayoutCache layoutCache;
+  std::unordered_map<std::string, vk::ShaderModule> shaderModules;
+  std::unordered_map<std::string, SpirvReflection> reflections;
+  mutable std::mutex mutex;
+
+private:
+  StatusCode getShaderModule(const std::string& name, vk::ShaderModule& shaderModule);
+  StatusCode createShaderModule(const std::string& name, const uint32_t* code, size_t size, vk::ShaderModule& shaderModule);
+  StatusCode getLayout(const PipelineDescription& description, vk::PipelineLayout& layout);
+};
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,70 @@
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "core/configuration_manager.h"
+#include "render/vulkan/present_policy.h"
+
+namespace benpu {
+
+PresentPolicy PresentPolicy::fromConfiguration() {
+
+  ConfigurationManager& configuration = ConfigurationManager::getInstance();
+
+  std::string name = configuration.get<std::string>("presentPolicy", "mailbox");
+
+  PresentPolicy policy;
+
+  if (name == "immediate") {
+    policy = {name, vk::PresentModeKHR::eImmediate, 2, 1};
+  } else if (name == "fifo") {
+    policy = {name, vk::PresentModeKHR::eFifo, 3, 2};
+  } else if (name == "fifoRelaxed") {
+    policy = {name, vk::PresentModeKHR::eFifoRelaxed, 3, 2};
+  } else {
+    if (name != "mailbox") {
+      BOOST_LOG_TRIVIAL(warning) << "Unknown present policy " << name << ", using mailbox.";
+    }
+    policy = {"mailbox", vk::PresentModeKHR::eMailbox, 3, 2};
+  }
+
+  policy.imageCount = std::max(configuration.get<uint32_t>("swapchainImageCount", policy.imageCount), 1u);
+  policy.maxQueuedFrames = std::max(configuration.get<uint32_t>("maxQueuedFrames", policy.maxQueuedFrames), 1u);
+
+  return policy;
+}
+
+PresentLatencyTracker::PresentLatencyTracker(const std::string& policyName):
+  policyName{policyName},
+  reportTime{std::chrono::steady_clock::now()} {
+
+}
+
+void PresentLatencyTracker::acquireStarted() {
+  acquireTime = std::chrono::steady_clock::now();
+}
+
+void PresentLatencyTracker::presented() {
+
+  auto now = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::milli> latency = now - acquireTime;
+
+  totalLatency += latency;
+  maxLatency = std::max(maxLatency, latency);
+  ++frames;
+
+  if (now - reportTime < std::chrono::seconds(1)) {
+    return;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "Present policy " << policyName << ": acquire to present latency "
+    << totalLatency.count() / frames << " ms average, " << maxLatency.count() << " ms max over " << frames << " frames.";
+
+  reportTime = now;
+  totalLatency = std::chrono::duration<double, std::milli>(0);
+  maxLatency = std::chrono::duration<double, std::milli>(0);
+  frames = 0;
+}
+
+} //namespace benpu
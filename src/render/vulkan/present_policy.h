@@ -0,0 +1,42 @@
+#ifndef BENPU_PRESENT_POLICY_H_
+#define BENPU_PRESENT_POLICY_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <vulkan/vulkan.hpp>
+
+namespace benpu {
+
+// How frames reach the screen: the present mode, how many images the
+// swapchain holds and how many submitted frames may be queued on the GPU
+// before the CPU waits.
+struct PresentPolicy {
+  std::string name;
+  vk::PresentModeKHR presentMode;
+  uint32_t imageCount;
+  uint32_t maxQueuedFrames;
+
+  static PresentPolicy fromConfiguration();
+};
+
+class PresentLatencyTracker {
+public:
+  PresentLatencyTracker(const std::string& policyName);
+
+  void acquireStarted();
+  void presented();
+
+private:
+  std::string policyName;
+  std::chrono::steady_clock::time_point acquireTime;
+  std::chrono::steady_clock::time_point reportTime;
+  std::chrono::duration<double, std::milli> totalLatency{0};
+  std::chrono::duration<double, std::milli> maxLatency{0};
+  uint32_t frames = 0;
+};
+
+} //namespace benpu
+
+#endif
@@ -18,4 +18,8 @@ namespace benpu {
     return StatusCode::success;
   }
 
+  vk::Queue Queue::getQueue() const {
+    return queue;
+  }
+
 } //namespace benpu
@@ -12,6 +12,8 @@ namespace benpu {
 struct QueueFamilyIndices{
   std::optional<uint32_t> graphicsFamily;
   std::optional<uint32_t> presentFamily;
+  std::optional<uint32_t> computeFamily;
+  std::optional<uint32_t> transferFamily;
   bool isComplete() const noexcept { return graphicsFamily.has_value() && presentFamily.has_value(); }
 };
 
@@ -21,6 +23,7 @@ public:
   Queue(vk::Device& device);
 
   StatusCode initialize(uint32_t index);
+  vk::Queue getQueue() const;
 
 private:
   vk::Device& device;
@@ -0,0 +1,520 @@
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/render_graph.h"
+
+namespace benpu {
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t passIndex): graph{graph}, passIndex{passIndex} {
+
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(ResourceHandle resource, ResourceUsage usage) {
+  graph.passes[passIndex].accesses.push_back({resource, usage, false});
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(ResourceHandle resource, ResourceUsage usage) {
+  graph.passes[passIndex].accesses.push_back({resource, usage, true});
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::keepAlive() {
+  graph.passes[passIndex].keepAlive = true;
+  return *this;
+}
+
+RenderGraph::ResourceHandle RenderGraph::importImage(
+  const std::string& name,
+  vk::Image image,
+  vk::ImageLayout currentLayout,
+  vk::PipelineStageFlags2 readyStages,
+  vk::ImageAspectFlags aspect
+) {
+
+  Resource resource;
+  resource.name = name;
+  resource.image = image;
+  resource.range = vk::ImageSubresourceRange(
+    aspect,
+    0,
+    VK_REMAINING_MIP_LEVELS,
+    0,
+    VK_REMAINING_ARRAY_LAYERS
+  );
+  resource.layout = currentLayout;
+  // Stages the image becomes available at (e.g. the acquire semaphore wait
+  // stage), so the first barrier chains with the external dependency.
+  resource.writeStages = readyStages;
+
+  resources.push_back(resource);
+  return static_cast<ResourceHandle>(resources.size() - 1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::importBuffer(const std::string& name, vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size) {
+
+  Resource resource;
+  resource.name = name;
+  resource.buffer = buffer;
+  resource.offset = offset;
+  resource.size = size;
+
+  resources.push_back(resource);
+  return static_cast<ResourceHandle>(resources.size() - 1);
+}
+
+void RenderGraph::exportImage(ResourceHandle resource, vk::ImageLayout finalLayout) {
+  resources[resource].exported = true;
+  resources[resource].finalLayout = finalLayout;
+}
+
+void RenderGraph::exportBuffer(ResourceHandle resource) {
+  resources[resource].exported = true;
+}
+
+void RenderGraph::setQueueFamilies(uint32_t graphicsFamily, std::optional<uint32_t> computeFamily) {
+  this->graphicsFamily = graphicsFamily;
+  this->computeFamily = computeFamily;
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const std::string& name, PassCallback callback, QueueType queue) {
+
+  Pass pass;
+  pass.name = name;
+  pass.callback = std::move(callback);
+  // Without a compute queue compute passes simply run on the graphics one.
+  pass.queue = computeFamily ? queue : QueueType::graphics;
+  passes.push_back(std::move(pass));
+
+  return PassBuilder(*this, static_cast<uint32_t>(passes.size() - 1));
+}
+
+StatusCode RenderGraph::compile() {
+
+  for (const Pass& pass : passes) {
+    for (const Access& access : pass.accesses) {
+      if (access.resource >= resources.size()) {
+        BOOST_LOG_TRIVIAL(error) << "Render pass " << pass.name << " accesses an unknown resource.";
+        return StatusCode::renderGraphCompilationError;
+      }
+
+      if (resources[access.resource].buffer && access.usage != ResourceUsage::storage
+        && access.usage != ResourceUsage::transfer && access.usage != ResourceUsage::vertexInput
+        && access.usage != ResourceUsage::uniform) {
+        BOOST_LOG_TRIVIAL(error) << "Render pass " << pass.name << " uses buffer " << resources[access.resource].name << " as an image.";
+        return StatusCode::renderGraphCompilationError;
+      }
+    }
+  }
+
+  cullPasses();
+
+  batches.clear();
+
+  auto openBatch = [this](QueueType queue) {
+    Batch batch;
+    batch.queue = queue;
+    batches.push_back(std::move(batch));
+  };
+
+  // Imported resources are owned by the graphics queue, a leading graphics
+  // batch gives their ownership releases somewhere to be recorded.
+  for (const Pass& pass : passes) {
+    if (!pass.culled) {
+      if (pass.queue != QueueType::graphics) {
+        openBatch(QueueType::graphics);
+      }
+      break;
+    }
+  }
+
+  for (uint32_t i = 0; i < passes.size(); ++i) {
+    Pass& pass = passes[i];
+
+    if (pass.culled) {
+      continue;
+    }
+
+    if (batches.empty() || batches.back().queue != pass.queue) {
+      openBatch(pass.queue);
+    }
+
+    uint32_t batchIndex = static_cast<uint32_t>(batches.size() - 1);
+    batches[batchIndex].passes.push_back(i);
+
+    for (const Access& access : pass.accesses) {
+      Resource& resource = resources[access.resource];
+      UsageState state = getUsageState(access.usage, access.write);
+
+      // Barriers and semaphore waits on the compute queue may only name
+      // stages it supports.
+      if (pass.queue == QueueType::compute) {
+        state.stages &= vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer;
+
+        if (!state.stages) {
+          BOOST_LOG_TRIVIAL(error) << "Render pass " << pass.name << " uses " << resource.name << " in a way the compute queue can't.";
+          return StatusCode::renderGraphCompilationError;
+        }
+      }
+
+      if (resource.queue != pass.queue) {
+        transferOwnership(resource, state, access.write, batchIndex, pass.imageBarriers, pass.bufferBarriers);
+      } else {
+        addBarrier(resource, state, access.write, pass.imageBarriers, pass.bufferBarriers);
+      }
+
+      resource.lastBatch = batchIndex;
+    }
+  }
+
+  // The frame is handed over to present or to the next frame on the
+  // graphics queue, so the graph always ends with a graphics batch.
+  if (batches.empty() || batches.back().queue != QueueType::graphics) {
+    openBatch(QueueType::graphics);
+  }
+
+  uint32_t lastBatch = static_cast<uint32_t>(batches.size() - 1);
+
+  for (Resource& resource : resources) {
+    // The consumer (present or a semaphore signal) provides the remaining
+    // execution dependency.
+    UsageState state{
+      vk::PipelineStageFlagBits2::eNone,
+      vk::AccessFlagBits2::eNone,
+      resource.finalLayout.value_or(resource.layout)
+    };
+
+    if (resource.queue != QueueType::graphics) {
+      transferOwnership(resource, state, false, lastBatch, finalImageBarriers, finalBufferBarriers);
+    } else if (resource.finalLayout && resource.layout != resource.finalLayout.value()) {
+      addBarrier(resource, state, false, finalImageBarriers, finalBufferBarriers);
+    }
+  }
+
+  return StatusCode::success;
+}
+
+void RenderGraph::execute(vk::CommandBuffer commandBuffer) {
+
+  for (uint32_t i = 0; i < batches.size(); ++i) {
+    executeBatch(i, commandBuffer);
+  }
+}
+
+void RenderGraph::executeBatch(uint32_t batchIndex, vk::CommandBuffer commandBuffer) {
+
+  const Batch& batch = batches[batchIndex];
+
+  for (uint32_t passIndex : batch.passes) {
+    const Pass& pass = passes[passIndex];
+
+    recordBarriers(commandBuffer, pass.imageBarriers, pass.bufferBarriers);
+    pass.callback(commandBuffer);
+  }
+
+  recordBarriers(commandBuffer, batch.releaseImageBarriers, batch.releaseBufferBarriers);
+
+  if (batchIndex + 1 == batches.size()) {
+    recordBarriers(commandBuffer, finalImageBarriers, finalBufferBarriers);
+  }
+}
+
+void RenderGraph::reset() {
+  resources.clear();
+  passes.clear();
+  batches.clear();
+  finalImageBarriers.clear();
+  finalBufferBarriers.clear();
+  culledPassCount = 0;
+}
+
+const std::vector<RenderGraph::Batch>& RenderGraph::getBatches() const {
+  return batches;
+}
+
+uint32_t RenderGraph::getCulledPassCount() const {
+  return culledPassCount;
+}
+
+const std::vector<vk::ImageMemoryBarrier2>& RenderGraph::getPassImageBarriers(uint32_t passIndex) const {
+  return passes[passIndex].imageBarriers;
+}
+
+const std::vector<vk::BufferMemoryBarrier2>& RenderGraph::getPassBufferBarriers(uint32_t passIndex) const {
+  return passes[passIndex].bufferBarriers;
+}
+
+const std::vector<vk::ImageMemoryBarrier2>& RenderGraph::getFinalImageBarriers() const {
+  return finalImageBarriers;
+}
+
+const std::vector<vk::BufferMemoryBarrier2>& RenderGraph::getFinalBufferBarriers() const {
+  return finalBufferBarriers;
+}
+
+RenderGraph::UsageState RenderGraph::getUsageState(ResourceUsage usage, bool write) {
+
+  switch (usage) {
+    case ResourceUsage::colorAttachment:
+      return {
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        write ? vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eColorAttachmentRead
+          : vk::AccessFlagBits2::eColorAttachmentRead,
+        vk::ImageLayout::eColorAttachmentOptimal
+      };
+    case ResourceUsage::depthAttachment:
+      return {
+        vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+        write ? vk::AccessFlagBits2::eDepthStencilAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentRead
+          : vk::AccessFlagBits2::eDepthStencilAttachmentRead,
+        write ? vk::ImageLayout::eDepthStencilAttachmentOptimal : vk::ImageLayout::eDepthStencilReadOnlyOptimal
+      };
+    case ResourceUsage::shaderRead:
+      return {
+        vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eFragmentShader
+          | vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderSampledRead,
+        vk::ImageLayout::eShaderReadOnlyOptimal
+      };
+    case ResourceUsage::storage:
+      return {
+        vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+        write ? vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eShaderStorageRead
+          : vk::AccessFlagBits2::eShaderStorageRead,
+        vk::ImageLayout::eGeneral
+      };
+    case ResourceUsage::transfer:
+      return {
+        vk::PipelineStageFlagBits2::eTransfer,
+        write ? vk::AccessFlagBits2::eTransferWrite : vk::AccessFlagBits2::eTransferRead,
+        write ? vk::ImageLayout::eTransferDstOptimal : vk::ImageLayout::eTransferSrcOptimal
+      };
+    case ResourceUsage::vertexInput:
+      return {
+        vk::PipelineStageFlagBits2::eVertexAttributeInput | vk::PipelineStageFlagBits2::eIndexInput,
+        vk::AccessFlagBits2::eVertexAttributeRead | vk::AccessFlagBits2::eIndexRead,
+        vk::ImageLayout::eUndefined
+      };
+    case ResourceUsage::uniform:
+      return {
+        vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eFragmentShader
+          | vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eUniformRead,
+        vk::ImageLayout::eUndefined
+      };
+  }
+
+  return {vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryRead, vk::ImageLayout::eGeneral};
+}
+
+void RenderGraph::cullPasses() {
+
+  // Walk the passes backwards from the exported resources, a pass survives
+  // only if something downstream consumes one of the resources it writes.
+  std::vector<bool> needed(resources.size(), false);
+  for (size_t i = 0; i < resources.size(); ++i) {
+    needed[i] = resources[i].exported;
+  }
+
+  for (auto pass = passes.rbegin(); pass != passes.rend(); ++pass) {
+    bool alive = pass->keepAlive;
+
+    for (const Access& access : pass->accesses) {
+      if (access.write && needed[access.resource]) {
+        alive = true;
+      }
+    }
+
+    pass->culled = !alive;
+    if (!alive) {
+      ++culledPassCount;
+      BOOST_LOG_TRIVIAL(debug) << "Culling render pass " << pass->name << ", its outputs are never used.";
+      continue;
+    }
+
+    for (const Access& access : pass->accesses) {
+      if (!access.write) {
+        needed[access.resource] = true;
+      }
+    }
+  }
+}
+
+uint32_t RenderGraph::getQueueFamily(QueueType queue) const {
+  return queue == QueueType::compute ? computeFamily.value() : graphicsFamily;
+}
+
+void RenderGraph::transferOwnership(Resource& resource, const UsageState& state, bool write, uint32_t batchIndex,
+  std::vector<vk::ImageMemoryBarrier2>& imageBarriers, std::vector<vk::BufferMemoryBarrier2>& bufferBarriers) {
+
+  Batch& releasing = batches[resource.lastBatch];
+  Batch& acquiring = batches[batchIndex];
+
+  uint32_t srcFamily = getQueueFamily(resource.queue);
+  uint32_t dstFamily = getQueueFamily(acquiring.queue);
+  vk::PipelineStageFlags2 srcStages = resource.writeStages | resource.readStages;
+
+  // The release half goes at the end of the batch that used the resource
+  // last, the acquire half into the pass, with matching layouts.
+  if (resource.image) {
+    releasing.releaseImageBarriers.emplace_back(
+      srcStages,
+      resource.writeAccess,
+      vk::PipelineStageFlagBits2::eNone,
+      vk::AccessFlagBits2::eNone,
+      resource.layout,
+      state.layout,
+      srcFamily,
+      dstFamily,
+      resource.image,
+      resource.range
+    );
+
+    imageBarriers.emplace_back(
+      vk::PipelineStageFlagBits2::eNone,
+      vk::AccessFlagBits2::eNone,
+      state.stages,
+      state.access,
+      resource.layout,
+      state.layout,
+      srcFamily,
+      dstFamily,
+      resource.image,
+      resource.range
+    );
+
+    resource.layout = state.layout;
+  } else {
+    releasing.releaseBufferBarriers.emplace_back(
+      srcStages,
+      resource.writeAccess,
+      vk::PipelineStageFlagBits2::eNone,
+      vk::AccessFlagBits2::eNone,
+      srcFamily,
+      dstFamily,
+      resource.buffer,
+      resource.offset,
+      resource.size
+    );
+
+    bufferBarriers.emplace_back(
+      vk::PipelineStageFlagBits2::eNone,
+      vk::AccessFlagBits2::eNone,
+      state.stages,
+      state.access,
+      srcFamily,
+      dstFamily,
+      resource.buffer,
+      resource.offset,
+      resource.size
+    );
+  }
+
+  vk::PipelineStageFlags2 waitStages = state.stages ? state.stages : vk::PipelineStageFlagBits2::eAllCommands;
+
+  auto wait = std::find_if(acquiring.waits.begin(), acquiring.waits.end(), [&resource](const BatchWait& wait) {
+    return wait.batch == resource.lastBatch;
+  });
+
+  if (wait != acquiring.waits.end()) {
+    wait->stages |= waitStages;
+  } else {
+    acquiring.waits.push_back({resource.lastBatch, waitStages});
+  }
+
+  resource.queue = acquiring.queue;
+  resource.writeStages = state.stages;
+  resource.writeAccess = write ? state.access : vk::AccessFlags2();
+  resource.readStages = write ? vk::PipelineStageFlags2() : state.stages;
+}
+
+void RenderGraph::addBarrier(Resource& resource, const UsageState& state, bool write,
+  std::vector<vk::ImageMemoryBarrier2>& imageBarriers, std::vector<vk::BufferMemoryBarrier2>& bufferBarriers) {
+
+  bool isImage = static_cast<bool>(resource.image);
+  bool layoutChange = isImage && resource.layout != state.layout;
+
+  bool needed = false;
+  vk::PipelineStageFlags2 srcStages;
+  vk::AccessFlags2 srcAccess;
+
+  if (write || layoutChange) {
+    // Write after write, write after read and layout transitions all have to
+    // wait for every access since the last write.
+    srcStages = resource.writeStages | resource.readStages;
+    srcAccess = resource.writeAccess;
+    needed = layoutChange || srcStages;
+  } else {
+    // Read after write, skipped when an earlier barrier already made the last
+    // write visible to these stages.
+    srcStages = resource.writeStages;
+    srcAccess = resource.writeAccess;
+    needed = resource.writeAccess && (resource.readStages & state.stages) != state.stages;
+  }
+
+  if (needed) {
+    if (isImage) {
+      imageBarriers.emplace_back(
+        srcStages,
+        srcAccess,
+        state.stages,
+        state.access,
+        resource.layout,
+        state.layout,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        resource.image,
+        resource.range
+      );
+    } else {
+      bufferBarriers.emplace_back(
+        srcStages,
+        srcAccess,
+        state.stages,
+        state.access,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        resource.buffer,
+        resource.offset,
+        resource.size
+      );
+    }
+  }
+
+  if (write) {
+    resource.writeStages = state.stages;
+    resource.writeAccess = state.access;
+    resource.readStages = vk::PipelineStageFlags2();
+  } else if (layoutChange) {
+    // The transition itself acts as the last write, made visible to the
+    // stages of this read only.
+    resource.writeStages = state.stages;
+    resource.writeAccess = vk::AccessFlags2();
+    resource.readStages = state.stages;
+  } else {
+    resource.readStages |= state.stages;
+  }
+
+  if (isImage) {
+    resource.layout = state.layout;
+  }
+}
+
+void RenderGraph::recordBarriers(vk::CommandBuffer commandBuffer,
+  const std::vector<vk::ImageMemoryBarrier2>& imageBarriers, const std::vector<vk::BufferMemoryBarrier2>& bufferBarriers) {
+
+  if (imageBarriers.empty() && bufferBarriers.empty()) {
+    return;
+  }
+
+  vk::DependencyInfo dependencyInfo;
+  dependencyInfo.setImageMemoryBarriers(imageBarriers);
+  dependencyInfo.setBufferMemoryBarriers(bufferBarriers);
+
+  commandBuffer.pipelineBarrier2(dependencyInfo);
+}
+
+} //namespace benpu
+
@@ -0,0 +1,164 @@
+#ifndef BENPU_RENDER_GRAPH_H_
+#define BENPU_RENDER_GRAPH_H_
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "status_code.h"
+
+namespace benpu {
+
+enum class ResourceUsage {
+  colorAttachment,
+  depthAttachment,
+  shaderRead,
+  storage,
+  transfer,
+  vertexInput,
+  uniform
+};
+
+enum class QueueType {
+  graphics,
+  compute
+};
+
+// Frame graph of passes over imported images and buffers. Passes declare
+// what they read and write, the graph culls the passes whose results are
+// never consumed and records the minimal set of synchronization2 barriers,
+// batched into a single vkCmdPipelineBarrier2 per pass.
+//
+// Compute passes are grouped into batches for the compute queue when one is
+// available. Resources crossing queues get release/acquire ownership
+// barriers and the acquiring batch waits on the releasing one.
+class RenderGraph {
+public:
+  using ResourceHandle = uint32_t;
+  using PassCallback = std::function<void(vk::CommandBuffer)>;
+
+  struct BatchWait {
+    uint32_t batch;
+    vk::PipelineStageFlags2 stages;
+  };
+
+  struct Batch {
+    QueueType queue;
+    std::vector<uint32_t> passes;
+    std::vector<BatchWait> waits;
+    std::vector<vk::ImageMemoryBarrier2> releaseImageBarriers;
+    std::vector<vk::BufferMemoryBarrier2> releaseBufferBarriers;
+  };
+
+  class PassBuilder {
+  public:
+    PassBuilder& read(ResourceHandle resource, ResourceUsage usage);
+    PassBuilder& write(ResourceHandle resource, ResourceUsage usage);
+    PassBuilder& keepAlive();
+
+  private:
+    friend class RenderGraph;
+    PassBuilder(RenderGraph& graph, uint32_t passIndex);
+
+    RenderGraph& graph;
+    uint32_t passIndex;
+  };
+
+  ResourceHandle importImage(
+    const std::string& name,
+    vk::Image image,
+    vk::ImageLayout currentLayout,
+    vk::PipelineStageFlags2 readyStages = vk::PipelineStageFlagBits2::eNone,
+    vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor
+  );
+  ResourceHandle importBuffer(const std::string& name, vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize size = VK_WHOLE_SIZE);
+  void exportImage(ResourceHandle resource, vk::ImageLayout finalLayout);
+  void exportBuffer(ResourceHandle resource);
+
+  void setQueueFamilies(uint32_t graphicsFamily, std::optional<uint32_t> computeFamily);
+
+  PassBuilder addPass(const std::string& name, PassCallback callback, QueueType queue = QueueType::graphics);
+
+  StatusCode compile();
+  void execute(vk::CommandBuffer commandBuffer);
+  void executeBatch(uint32_t batchIndex, vk::CommandBuffer commandBuffer);
+  void reset();
+
+  const std::vector<Batch>& getBatches() const;
+  uint32_t getCulledPassCount() const;
+  const std::vector<vk::ImageMemoryBarrier2>& getPassImageBarriers(uint32_t passIndex) const;
+  const std::vector<vk::BufferMemoryBarrier2>& getPassBufferBarriers(uint32_t passIndex) const;
+  const std::vector<vk::ImageMemoryBarrier2>& getFinalImageBarriers() const;
+  const std::vector<vk::BufferMemoryBarrier2>& getFinalBufferBarriers() const;
+
+private:
+  struct UsageState {
+    vk::PipelineStageFlags2 stages;
+    vk::AccessFlags2 access;
+    vk::ImageLayout layout;
+  };
+
+  struct Access {
+    ResourceHandle resource;
+    ResourceUsage usage;
+    bool write;
+  };
+
+  struct Pass {
+    std::string name;
+    PassCallback callback;
+    QueueType queue = QueueType::graphics;
+    std::vector<Access> accesses;
+    bool keepAlive = false;
+    bool culled = false;
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+  };
+
+  struct Resource {
+    std::string name;
+    vk::Image image = nullptr;
+    vk::ImageSubresourceRange range;
+    vk::Buffer buffer = nullptr;
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize size = VK_WHOLE_SIZE;
+    bool exported = false;
+    std::optional<vk::ImageLayout> finalLayout;
+
+    vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+    vk::PipelineStageFlags2 writeStages;
+    vk::AccessFlags2 writeAccess;
+    vk::PipelineStageFlags2 readStages;
+    QueueType queue = QueueType::graphics;
+    uint32_t lastBatch = 0;
+  };
+
+  uint32_t graphicsFamily = VK_QUEUE_FAMILY_IGNORED;
+  std::optional<uint32_t> computeFamily;
+  std::vector<Resource> resources;
+  std::vector<Pass> passes;
+  std::vector<Batch> batches;
+  std::vector<vk::ImageMemoryBarrier2> finalImageBarriers;
+  std::vector<vk::BufferMemoryBarrier2> finalBufferBarriers;
+  uint32_t culledPassCount = 0;
+
+private:
+  static UsageState getUsageState(ResourceUsage usage, bool write);
+
+  void cullPasses();
+  uint32_t getQueueFamily(QueueType queue) const;
+  void transferOwnership(Resource& resource, const UsageState& state, bool write, uint32_t batchIndex,
+    std::vector<vk::ImageMemoryBarrier2>& imageBarriers, std::vector<vk::BufferMemoryBarrier2>& bufferBarriers);
+  void addBarrier(Resource& resource, const UsageState& state, bool write,
+    std::vector<vk::ImageMemoryBarrier2>& imageBarriers, std::vector<vk::BufferMemoryBarrier2>& bufferBarriers);
+  void recordBarriers(vk::CommandBuffer commandBuffer,
+    const std::vector<vk::ImageMemoryBarrier2>& imageBarriers, const std::vector<vk::BufferMemoryBarrier2>& bufferBarriers);
+};
+
+} //namespace benpu
+
+#endif
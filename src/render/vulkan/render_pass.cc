@@ -19,8 +19,9 @@ StatusCode RenderPass::initialize(vk::Format swapChainImageFormat) {
     vk::AttachmentStoreOp::eStore,
     vk::AttachmentLoadOp::eDontCare,
     vk::AttachmentStoreOp::eDontCare,
-    vk::ImageLayout::eUndefined,
-    vk::ImageLayout::ePresentSrcKHR
+    // Layout transitions in and out of the pass are recorded by the render graph.
+    vk::ImageLayout::eColorAttachmentOptimal,
+    vk::ImageLayout::eColorAttachmentOptimal
   );
 
   vk::AttachmentReference colorAttachmentRef(
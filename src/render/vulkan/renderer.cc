@@ -1,31 +1,67 @@
 
+#include <algorithm>
+#include <chrono>
 #include <set>
+#include <thread>
 
 #include <boost/log/trivial.hpp>
+#include <glm/glm.hpp>
 
 #include "core/configuration_manager.h"
+#include "core/utils/frame_pacer.h"
+#include "core/utils/system.h"
 #include "render/vulkan/command_pool.h"
 #include "render/vulkan/renderer.h"
 #include "render/vulkan/swapchain.h"
 
 namespace benpu {
 
+//Matches the DrawConstants block of first.vert.
+struct DrawConstants {
+  glm::vec4 transform;
+};
+
 Renderer& Renderer::getInstance() {
   static Renderer instance;
   return instance;
 }
 
 Renderer::Renderer():
-  mainWindow{
-    ConfigurationManager::getInstance()["screenSize"]["x"],
-    ConfigurationManager::getInstance()["screenSize"]["y"]
-  },
-  pipeline(device),
+  memoryAllocator(device),
+  bindlessTable(device),
+  descriptorAllocator(device),
+  uniformRing(device, memoryAllocator, descriptorAllocator),
+  graphicsQueue(device),
+  computeQueue(device),
+  presentPolicy(PresentPolicy::fromConfiguration()),
+  latencyTracker(presentPolicy.name),
+  pipelineCache(device),
+  pipelineCompiler(device),
+  pipelineRegistry(device, pipelineCompiler),
   swapchain(device),
   renderPass(device),
-  commandPool(device) {
-  
-  vkfw::init();
+  commandPool(device),
+  computeCommandPool(device),
+  uploadEngine(device, memoryAllocator),
+  geometryBuffer(device, memoryAllocator),
+  recorder(device),
+  staticCommandCache(device),
+  timeline(device),
+  computeTimeline(device) {
+
+  ConfigurationManager& configuration = ConfigurationManager::getInstance();
+
+  headless = configuration.get<bool>("headless", false);
+  dynamicRendering = configuration.get<bool>("dynamicRendering", true);
+  asyncCompute = configuration.get<bool>("asyncCompute", true);
+
+  if (!headless) {
+    vkfw::init();
+    mainWindow = std::make_unique<Window>(
+      configuration["screenSize"]["x"].get<uint32_t>(),
+      configuration["screenSize"]["y"].get<uint32_t>()
+    );
+  }
 
   if (createVulkanInstance() != StatusCode::success) {
     BOOST_LOG_TRIVIAL(error) << "Couldn't create Vulkan instance.";
@@ -33,15 +69,17 @@ Renderer::Renderer():
     return;
   }
 
-  if (swapchain.setSurface(instance, mainWindow) != StatusCode::success) {
+  if (createSurface() != StatusCode::success) {
     BOOST_LOG_TRIVIAL(error) << "Couldn't create windown surface.";
     status = ObjectStatus::error;
     return;
   }
 
-  std::vector<const char*> requiredExtensions = { 
-    VK_KHR_SWAPCHAIN_EXTENSION_NAME 
-  };
+  std::vector<const char*> requiredExtensions;
+
+  if (swapchain.getSurface()) {
+    requiredExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+  }
 
   QueueFamilyIndices queueFamilyIndices;
 
@@ -57,37 +95,131 @@ Renderer::Renderer():
     return;
   }
 
-  if(swapchain.initialize(physicalDevice, queueFamilyIndices, mainWindow) != StatusCode::success) {
+  if(memoryAllocator.initialize(physicalDevice, configuration.get<vk::DeviceSize>("memoryBlockSize", 64 * 1024 * 1024)) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create memory allocator.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  if(bindlessTable.initialize(
+      physicalDevice,
+      configuration.get<uint32_t>("bindlessStorageBuffers", 8192),
+      configuration.get<uint32_t>("bindlessSamplers", 256),
+      configuration.get<uint32_t>("bindlessSampledImages", 16384)
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create bindless table.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  if(graphicsQueue.initialize(queueFamilyIndices.graphicsFamily.value()) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create graphics queue.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  computeQueueAvailable = queueFamilyIndices.computeFamily.has_value();
+
+  if (computeQueueAvailable) {
+    BOOST_LOG_TRIVIAL(info) << "Using queue family " << queueFamilyIndices.computeFamily.value() << " for async compute.";
+
+    if(computeQueue.initialize(queueFamilyIndices.computeFamily.value()) != StatusCode::success) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't create compute queue.";
+      status = ObjectStatus::error;
+      return;
+    }
+  }
+
+  renderGraph.setQueueFamilies(queueFamilyIndices.graphicsFamily.value(), queueFamilyIndices.computeFamily);
+
+  uint32_t framesInFlight = std::max(configuration.get<uint32_t>("framesInFlight", 2), 1u);
+
+  StatusCode swapchainStatus = swapchain.getSurface()
+    ? swapchain.initialize(physicalDevice, queueFamilyIndices, getFramebufferExtent(), presentPolicy)
+    : swapchain.initializeOffscreen(memoryAllocator, getFramebufferExtent(), framesInFlight);
+
+  if(swapchainStatus != StatusCode::success) {
     BOOST_LOG_TRIVIAL(error) << "Couldn't create swapchain.";
     status = ObjectStatus::error;
     return;
   }
 
-  if(renderPass.initialize(swapchain.getFormat()) != StatusCode::success) {
-    BOOST_LOG_TRIVIAL(error) << "Couldn't create render pass.";
+  if(uniformRing.initialize(physicalDevice, framesInFlight, configuration.get<vk::DeviceSize>("uniformRingFrameSize", 4 * 1024 * 1024)) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create uniform ring.";
     status = ObjectStatus::error;
     return;
   }
 
-  if(pipeline.initialize() != StatusCode::success) {
-    BOOST_LOG_TRIVIAL(error) << "Couldn't create graphical pipeline.";
+  //Kept next to the configuration so every run of this user shares it.
+  if(pipelineCache.initialize(physicalDevice, System::getDefaultConfigurationFile().parent_path() / "pipeline_cache.bin") != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create pipeline cache.";
     status = ObjectStatus::error;
     return;
   }
 
-  if(swapchain.createFramebuffers(renderPass) != StatusCode::success) {
-    BOOST_LOG_TRIVIAL(error) << "Couldn't create frame buffers.";
+  if (!dynamicRendering) {
+    if(renderPass.initialize(swapchain.getFormat()) != StatusCode::success) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't create render pass.";
+      status = ObjectStatus::error;
+      return;
+    }
+
+    if(swapchain.createFramebuffers(renderPass) != StatusCode::success) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't create frame buffers.";
+      status = ObjectStatus::error;
+      return;
+    }
+  }
+
+  uint32_t compileThreads = configuration.get<uint32_t>("pipelineCompileThreads", 0);
+  if (compileThreads == 0) {
+    compileThreads = std::max(std::thread::hardware_concurrency() / 2, 1u);
+  }
+
+  if(pipelineCompiler.initialize(compileThreads, pipelineCache.getPipelineCache()) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create pipeline compiler.";
     status = ObjectStatus::error;
     return;
   }
 
-  if(commandPool.initialize(queueFamilyIndices) != StatusCode::success) {
+  triangleDescription.vertexShader = "first.vert.spv";
+  triangleDescription.fragmentShader = "first.frag.spv";
+  triangleDescription.vertexLayout = Vertex::getLayout();
+  triangleDescription.setLayouts = {bindlessTable.getLayout(), uniformRing.getLayout()};
+  triangleDescription.pushConstantRanges = {uniformRing.getPushConstantRange()};
+
+  //With dynamic rendering pipelines are built against the attachment
+  //formats, no render pass or framebuffers are needed.
+  if (dynamicRendering) {
+    triangleDescription.colorFormats = {swapchain.getFormat()};
+  } else {
+    triangleDescription.renderPass = renderPass.getRenderPass();
+  }
+
+  //Compiled in the background, frames before it's ready only clear.
+  trianglePipeline = pipelineRegistry.get(triangleDescription);
+
+#ifdef BENPU_SHADER_HOT_RELOAD
+  //Not fatal, the renderer just runs without hot reload.
+  if(shaderReloader.initialize(BENPU_SHADER_SOURCE_DIR) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(warning) << "Couldn't start shader hot reload.";
+  }
+#endif
+
+  if(commandPool.initialize(queueFamilyIndices.graphicsFamily.value(), framesInFlight) != StatusCode::success) {
     BOOST_LOG_TRIVIAL(error) << "Couldn't create command pool.";
     status = ObjectStatus::error;
     return;
   }
 
-  if(commandPool.createCommandBuffer() != StatusCode::success) {
+  if(computeQueueAvailable
+    && computeCommandPool.initialize(queueFamilyIndices.computeFamily.value(), framesInFlight) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create compute command pool.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  if(commandPool.createCommandBuffers() != StatusCode::success) {
     BOOST_LOG_TRIVIAL(error) << "Couldn't create command buffer.";
     status = ObjectStatus::error;
     return;
@@ -99,6 +231,89 @@ Renderer::Renderer():
     return;
   }
 
+  staticCommands = configuration.get<bool>("staticCommands", true);
+
+  if(staticCommandCache.initialize(queueFamilyIndices) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create static command pool.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  uint32_t recordingThreads = configuration.get<uint32_t>("recordingThreads", 0);
+  if (recordingThreads == 0) {
+    recordingThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  threadPool = std::make_unique<ThreadPool>(recordingThreads);
+
+  if(recorder.initialize(queueFamilyIndices, framesInFlight, threadPool->getThreadCount()) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create recording command pools.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  if(descriptorAllocator.initialize(
+      framesInFlight,
+      configuration.get<uint32_t>("descriptorSetsPerPool", 128),
+      //Only what the current consumers allocate, the uniform ring's set.
+      {
+        {vk::DescriptorType::eUniformBufferDynamic, 1.0f}
+      }
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create descriptor allocator.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  //Without a transfer-only family uploads go through the graphics family.
+  if(uploadEngine.initialize(
+      physicalDevice,
+      queueFamilyIndices.transferFamily.value_or(queueFamilyIndices.graphicsFamily.value()),
+      queueFamilyIndices.graphicsFamily.value(),
+      configuration.get<vk::DeviceSize>("stagingRingSize", 32 * 1024 * 1024)
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create upload engine.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  if(geometryBuffer.initialize(
+      configuration.get<uint32_t>("geometryVertexCapacity", 1024 * 1024),
+      configuration.get<uint32_t>("geometryIndexCapacity", 3 * 1024 * 1024)
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create geometry buffers.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  //Uploaded with the first frame, which waits on the transfer.
+  if(geometryBuffer.addMesh(
+      uploadEngine,
+      {
+        {{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+        {{0.5f, 0.5f}, {0.0f, 1.0f, 0.0f}},
+        {{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}}
+      },
+      {0, 1, 2},
+      triangle
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't upload triangle mesh.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  if(timeline.initialize() != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create frame timeline.";
+    status = ObjectStatus::error;
+    return;
+  }
+
+  if(computeTimeline.initialize() != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create compute timeline.";
+    status = ObjectStatus::error;
+    return;
+  }
+
   status = ObjectStatus::ok;
 }
 
@@ -160,9 +375,14 @@ int Renderer::getBestPhysicalDevice(const std::vector<vk::PhysicalDevice>& physi
     QueueFamilyIndices queueFamilyIndices;
     vk::PhysicalDeviceProperties deviceProperties = physicalDevices[i].getProperties();
     vk::PhysicalDeviceFeatures deviceFeatures = physicalDevices[i].getFeatures();
+    auto deviceFeatures2 = physicalDevices[i].getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features>();
+    const vk::PhysicalDeviceVulkan12Features& vulkan12Features = deviceFeatures2.get<vk::PhysicalDeviceVulkan12Features>();
+    const vk::PhysicalDeviceVulkan13Features& vulkan13Features = deviceFeatures2.get<vk::PhysicalDeviceVulkan13Features>();
     
     std::vector<vk::QueueFamilyProperties> queueFamiliesProperties = physicalDevices[i].getQueueFamilyProperties();
 
+    vk::SurfaceKHR surface = swapchain.getSurface();
+
     int score = 0;
     
     if (deviceProperties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu) {
@@ -187,9 +407,14 @@ int Renderer::getBestPhysicalDevice(const std::vector<vk::PhysicalDevice>& physi
       
       if (queueFamiliesProperties[j].queueFlags & vk::QueueFlagBits::eGraphics) {
         queueFamilyIndices.graphicsFamily = j;
+
+        //Without a surface nothing is presented, the graphics queue stands in.
+        if (!surface) {
+          queueFamilyIndices.presentFamily = j;
+        }
       }
 
-      if (physicalDevices[i].getSurfaceSupportKHR(j, swapchain.getSurface())) {
+      if (surface && physicalDevices[i].getSurfaceSupportKHR(j, surface)) {
         queueFamilyIndices.presentFamily = j;
       }
 
@@ -199,7 +424,49 @@ int Renderer::getBestPhysicalDevice(const std::vector<vk::PhysicalDevice>& physi
 
     }
     
+    // A compute family without graphics runs asynchronously to the graphics
+    // queue, any family other than the graphics one is the next best thing.
+    if (asyncCompute && queueFamilyIndices.graphicsFamily.has_value()) {
+      for (uint32_t j = 0; j < queueFamiliesProperties.size(); ++j) {
+        vk::QueueFlags flags = queueFamiliesProperties[j].queueFlags;
+
+        if (!(flags & vk::QueueFlagBits::eCompute) || j == queueFamilyIndices.graphicsFamily.value()) {
+          continue;
+        }
+
+        if (!(flags & vk::QueueFlagBits::eGraphics)) {
+          queueFamilyIndices.computeFamily = j;
+          break;
+        }
+
+        if (!queueFamilyIndices.computeFamily.has_value()) {
+          queueFamilyIndices.computeFamily = j;
+        }
+      }
+    }
+
+    // Transfer-only families are usually backed by dedicated copy engines.
+    for (uint32_t j = 0; j < queueFamiliesProperties.size(); ++j) {
+      vk::QueueFlags flags = queueFamiliesProperties[j].queueFlags;
+
+      if ((flags & vk::QueueFlagBits::eTransfer)
+        && !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+        queueFamilyIndices.transferFamily = j;
+        break;
+      }
+    }
+
     if (!deviceFeatures.geometryShader
+      || !vulkan12Features.timelineSemaphore
+      || !vulkan12Features.runtimeDescriptorArray
+      || !vulkan12Features.descriptorBindingPartiallyBound
+      || !vulkan12Features.descriptorBindingVariableDescriptorCount
+      || !vulkan12Features.descriptorBindingSampledImageUpdateAfterBind
+      || !vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind
+      || !vulkan12Features.shaderSampledImageArrayNonUniformIndexing
+      || !vulkan12Features.shaderStorageBufferArrayNonUniformIndexing
+      || !vulkan13Features.synchronization2
+      || (dynamicRendering && !vulkan13Features.dynamicRendering)
       || !queueFamilyIndices.isComplete()
       || !checkDeviceExtensionSupport(physicalDevices[i], requiredExtensions)) {
         //If it does support the queue families we need, we can't use it.
@@ -207,10 +474,12 @@ int Renderer::getBestPhysicalDevice(const std::vector<vk::PhysicalDevice>& physi
         continue; 
     }
 
-    SwapChainSupportDetails swapChainSupport = swapchain.querySwapChainSupport(physicalDevices[i]);
+    if (surface) {
+      SwapChainSupportDetails swapChainSupport = swapchain.querySwapChainSupport(physicalDevices[i]);
 
-    if (swapChainSupport.formats.empty() || swapChainSupport.presentModes.empty()) {
-      score = 0;
+      if (swapChainSupport.formats.empty() || swapChainSupport.presentModes.empty()) {
+        score = 0;
+      }
     }
     
     if (score > bestScore) {
@@ -255,7 +524,23 @@ StatusCode Renderer::createVulkanInstance() {
       VK_API_VERSION_1_3
     );
 
-    std::vector<const char *> requiredExtensions = Window::getRequiredVulkanExtensions();
+    std::vector<const char *> requiredExtensions;
+
+    if (!headless) {
+      requiredExtensions = Window::getRequiredVulkanExtensions();
+    } else if (ConfigurationManager::getInstance().get<bool>("headlessSurface", false)) {
+      std::vector<const char *> headlessExtensions{
+        VK_KHR_SURFACE_EXTENSION_NAME,
+        VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME
+      };
+
+      if (checkRequiredExtensions(headlessExtensions) == StatusCode::success) {
+        requiredExtensions = headlessExtensions;
+        headlessSurface = true;
+      } else {
+        BOOST_LOG_TRIVIAL(warning) << VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME << " isn't available, rendering into offscreen images.";
+      }
+    }
 
     requiredExtensions.push_back("VK_KHR_portability_enumeration");
 
@@ -296,6 +581,21 @@ StatusCode Renderer::createVulkanInstance() {
   return StatusCode::success;
 }
 
+StatusCode Renderer::createSurface() {
+
+  if (!headless) {
+    return swapchain.setSurface(instance, *mainWindow);
+  }
+
+  if (headlessSurface) {
+    BOOST_LOG_TRIVIAL(info) << "Creating headless surface.";
+    return swapchain.setHeadlessSurface(instance);
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "Running headless, frames are rendered into offscreen images.";
+  return StatusCode::success;
+}
+
 StatusCode Renderer::createDevice(QueueFamilyIndices& queueFamilyIndices, const std::vector<const char*>& requiredExtensions) {
   try {
 
@@ -308,6 +608,14 @@ StatusCode Renderer::createDevice(QueueFamilyIndices& queueFamilyIndices, const
     std::set<uint32_t> uniqueQueueFamilies = {queueFamilyIndices.graphicsFamily.value(),
                                               queueFamilyIndices.presentFamily.value()};
 
+    if (queueFamilyIndices.computeFamily.has_value()) {
+      uniqueQueueFamilies.insert(queueFamilyIndices.computeFamily.value());
+    }
+
+    if (queueFamilyIndices.transferFamily.has_value()) {
+      uniqueQueueFamilies.insert(queueFamilyIndices.transferFamily.value());
+    }
+
     for (uint32_t queueFamily : uniqueQueueFamilies) {
       vk::DeviceQueueCreateInfo queueCreateInfo(
         {},
@@ -317,7 +625,28 @@ StatusCode Renderer::createDevice(QueueFamilyIndices& queueFamilyIndices, const
       );
       queueCreateInfos.push_back(queueCreateInfo);
     }
-    vk::PhysicalDeviceFeatures deviceFeatures;
+
+    vk::PhysicalDeviceVulkan13Features vulkan13Features;
+    vulkan13Features.synchronization2 = vk::True;
+    vulkan13Features.dynamicRendering = dynamicRendering ? vk::True : vk::False;
+
+    vk::PhysicalDeviceVulkan12Features vulkan12Features;
+    vulkan12Features.timelineSemaphore = vk::True;
+    vulkan12Features.runtimeDescriptorArray = vk::True;
+    vulkan12Features.descriptorBindingPartiallyBound = vk::True;
+    vulkan12Features.descriptorBindingVariableDescriptorCount = vk::True;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = vk::True;
+    vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = vk::True;
+    //Non-uniform indexing of every table in shaders/bindless.glsl, samplers
+    //fall under the sampled image feature.
+    vulkan12Features.shaderSampledImageArrayNonUniformIndexing = vk::True;
+    vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = vk::True;
+    vulkan12Features.pNext = &vulkan13Features;
+
+    vk::PhysicalDeviceFeatures2 deviceFeatures(
+      vk::PhysicalDeviceFeatures(),
+      &vulkan12Features
+    );
 
     vk::DeviceCreateInfo deviceInfo(
       {},
@@ -327,6 +656,7 @@ StatusCode Renderer::createDevice(QueueFamilyIndices& queueFamilyIndices, const
       {},
       static_cast<uint32_t>(requiredExtensions.size()),
       requiredExtensions.data(),
+      nullptr,
       &deviceFeatures
     );
 
@@ -342,13 +672,504 @@ StatusCode Renderer::createDevice(QueueFamilyIndices& queueFamilyIndices, const
 
 void Renderer::mainLoop() {
 
-  while (!mainWindow.shouldClose()) {
-    mainWindow.pollEvents();
-    //drawFrame();
+  uint64_t frameCount = ConfigurationManager::getInstance().get<uint64_t>("frameCount", 0);
+  uint64_t renderedFrames = 0;
+
+  FramePacer pacer(ConfigurationManager::getInstance().get<double>("targetFrameRate", 0.0));
+
+  //Pipelines compiled while running are persisted periodically too, so a
+  //crash doesn't lose them. Zero saves only on shutdown.
+  std::chrono::seconds cacheSaveInterval(ConfigurationManager::getInstance().get<int64_t>("pipelineCacheSaveInterval", 60));
+
+  auto start = std::chrono::steady_clock::now();
+  auto lastCacheSave = start;
+
+  while (!shouldClose() && (frameCount == 0 || renderedFrames < frameCount)) {
+    pacer.wait();
+    if (mainWindow) {
+      mainWindow->pollEvents();
+    }
+#ifdef BENPU_SHADER_HOT_RELOAD
+    swapReloadedPipelines();
+#endif
+    drawFrame();
+    ++renderedFrames;
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (cacheSaveInterval.count() > 0 && now - lastCacheSave >= cacheSaveInterval) {
+      pipelineCache.save();
+      lastCacheSave = now;
+    }
   }
   device.waitIdle();
+
+  pipelineCache.save();
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+  if (renderedFrames > 0) {
+    BOOST_LOG_TRIVIAL(info) << "Rendered " << renderedFrames << " frames in " << elapsed.count() << " ms ("
+      << elapsed.count() / renderedFrames << " ms per frame).";
+  }
+
+  memoryAllocator.logStats();
+}
+
+vk::Extent2D Renderer::getFramebufferExtent() const {
+
+  if (mainWindow) {
+    auto [width, height] = mainWindow->getFramebufferSize();
+    return vk::Extent2D(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+  }
+
+  ConfigurationManager& configuration = ConfigurationManager::getInstance();
+
+  return vk::Extent2D(
+    configuration["screenSize"]["x"].get<uint32_t>(),
+    configuration["screenSize"]["y"].get<uint32_t>()
+  );
+}
+
+bool Renderer::shouldClose() const {
+  return mainWindow && mainWindow->shouldClose();
+}
+
+StatusCode Renderer::buildRenderGraph(uint32_t imageIndex) {
+
+  // The graph is rebuilt every frame, its vectors keep their capacity.
+  renderGraph.reset();
+
+  RenderGraph::ResourceHandle backbuffer = renderGraph.importImage(
+    "backbuffer",
+    swapchain.getImage(imageIndex),
+    vk::ImageLayout::eUndefined,
+    vk::PipelineStageFlagBits2::eColorAttachmentOutput
+  );
+
+  renderGraph.exportImage(
+    backbuffer,
+    swapchain.isOffscreen() ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR
+  );
+
+  std::shared_ptr<Pipeline> pipeline = PipelineCompiler::resolve(trianglePipeline);
+
+  renderGraph.addPass("triangle", [this, imageIndex, pipeline](vk::CommandBuffer commandBuffer) {
+    vk::Extent2D extent = swapchain.getExtent();
+    vk::ClearValue clearColor = {{0.0f, 0.0f, 0.0f, 0.0f}};
+    vk::Rect2D renderArea(
+      {
+        0,
+        0
+      },
+      extent
+    );
+
+    // Draws are recorded into secondaries on the worker threads, the primary
+    // only opens the pass and executes them.
+    vk::Format colorFormat = swapchain.getFormat();
+
+    vk::CommandBufferInheritanceRenderingInfo renderingInheritance(
+      {},
+      0,
+      1,
+      &colorFormat,
+      vk::Format::eUndefined,
+      vk::Format::eUndefined,
+      vk::SampleCountFlagBits::e1
+    );
+
+    vk::CommandBufferInheritanceInfo inheritanceInfo(
+      dynamicRendering ? vk::RenderPass() : renderPass.getRenderPass(),
+      0,
+      dynamicRendering ? vk::Framebuffer() : swapchain.getFramebuffer(imageIndex),
+      vk::False,
+      {},
+      {},
+      dynamicRendering ? &renderingInheritance : nullptr
+    );
+
+    ParallelRecorder::RecordCallback recordTriangle = [this, extent, pipeline](vk::CommandBuffer secondary) {
+      recordDraws(secondary, extent, *pipeline);
+    };
+
+    std::vector<vk::CommandBuffer> secondaryCommandBuffers;
+
+    if (!pipeline) {
+      // Still compiling, the pass only clears.
+    } else if (staticCommands) {
+      // The triangle never changes, it is recorded once per swapchain image
+      // and replayed until the swapchain is rebuilt. Its constants fit in
+      // push constants, a uniform ring set wouldn't outlive its frame.
+      vk::CommandBuffer triangleCommands;
+
+      if (staticCommandCache.get("triangle", imageIndex, inheritanceInfo, recordTriangle, triangleCommands) == StatusCode::success) {
+        secondaryCommandBuffers.push_back(triangleCommands);
+      } else {
+        BOOST_LOG_TRIVIAL(error) << "Couldn't record static command buffers.";
+      }
+    } else {
+      std::vector<ParallelRecorder::RecordCallback> draws{recordTriangle};
+
+      if (recorder.record(*threadPool, inheritanceInfo, draws, secondaryCommandBuffers) != StatusCode::success) {
+        BOOST_LOG_TRIVIAL(error) << "Couldn't record secondary command buffers.";
+        secondaryCommandBuffers.clear();
+      }
+    }
+
+    if (dynamicRendering) {
+      vk::RenderingAttachmentInfo colorAttachment(
+        swapchain.getImageView(imageIndex),
+        vk::ImageLayout::eColorAttachmentOptimal,
+        vk::ResolveModeFlagBits::eNone,
+        nullptr,
+        vk::ImageLayout::eUndefined,
+        vk::AttachmentLoadOp::eClear,
+        vk::AttachmentStoreOp::eStore,
+        clearColor
+      );
+
+      vk::RenderingInfo renderingInfo(
+        vk::RenderingFlagBits::eContentsSecondaryCommandBuffers,
+        renderArea,
+        1,
+        0,
+        1,
+        &colorAttachment
+      );
+
+      commandBuffer.beginRendering(renderingInfo);
+    } else {
+      vk::RenderPassBeginInfo renderPassInfo(
+        renderPass.getRenderPass(),
+        swapchain.getFramebuffer(imageIndex),
+        renderArea,
+        1,
+        &clearColor
+      );
+
+      commandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+    }
+
+    if (!secondaryCommandBuffers.empty()) {
+      commandBuffer.executeCommands(secondaryCommandBuffers);
+    }
+
+    if (dynamicRendering) {
+      commandBuffer.endRendering();
+    } else {
+      commandBuffer.endRenderPass();
+    }
+  }).write(backbuffer, ResourceUsage::colorAttachment);
+
+  return renderGraph.compile();
+}
+
+StatusCode Renderer::recordBatch(vk::CommandBuffer commandBuffer, uint32_t batchIndex, bool acquireUploads) {
+
+  vk::CommandBufferBeginInfo beginInfo(
+    vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+    nullptr
+  );
+
+  if (commandBuffer.begin(&beginInfo) != vk::Result::eSuccess) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while command buffer record.";
+    return StatusCode::commandBufferRecordError;
+  }
+
+  if (acquireUploads) {
+    uploadEngine.recordAcquireBarriers(commandBuffer);
+  }
+
+  renderGraph.executeBatch(batchIndex, commandBuffer);
+
+  commandBuffer.end();
+
+  return StatusCode::success;
+}
+
+StatusCode Renderer::submitRenderGraph(FrameResources& frame, uint32_t imageIndex) {
+
+  const std::vector<RenderGraph::Batch>& batches = renderGraph.getBatches();
+  std::vector<uint64_t> batchValues(batches.size(), 0);
+
+  // Offscreen images are neither acquired nor presented, so only the
+  // timelines take part in the submissions.
+  bool offscreen = swapchain.isOffscreen();
+  bool imageWaited = offscreen;
+  // Uploads flushed since the previous frame are waited on and acquired by
+  // the first graphics batch.
+  uint64_t uploadValue = uploadEngine.takeGraphicsWaitValue();
+  bool uploadsAcquired = false;
+
+  commandPool.resetCommandBuffers(currentFrame);
+  if (computeQueueAvailable) {
+    computeCommandPool.resetCommandBuffers(currentFrame);
+  }
+
+  for (uint32_t i = 0; i < batches.size(); ++i) {
+    const RenderGraph::Batch& batch = batches[i];
+    bool compute = batch.queue == QueueType::compute;
+    Timeline& batchTimeline = compute ? computeTimeline : timeline;
+
+    vk::CommandBuffer commandBuffer = compute
+      ? computeCommandPool.nextCommandBuffer(currentFrame)
+      : commandPool.nextCommandBuffer(currentFrame);
+
+    bool acquireUploads = !compute && !uploadsAcquired;
+
+    if (!commandBuffer || recordBatch(commandBuffer, i, acquireUploads) != StatusCode::success) {
+      return StatusCode::commandBufferRecordError;
+    }
+
+    std::vector<vk::SemaphoreSubmitInfo> waits;
+
+    for (const RenderGraph::BatchWait& wait : batch.waits) {
+      Timeline& waitTimeline = batches[wait.batch].queue == QueueType::compute ? computeTimeline : timeline;
+      waits.emplace_back(waitTimeline.getSemaphore(), batchValues[wait.batch], wait.stages);
+    }
+
+    if (acquireUploads) {
+      if (uploadValue != 0) {
+        waits.emplace_back(uploadEngine.getTimeline().getSemaphore(), uploadValue, vk::PipelineStageFlagBits2::eAllCommands);
+      }
+      uploadsAcquired = true;
+    }
+
+    if (!compute && !imageWaited) {
+      waits.emplace_back(frame.imageAvailableSemaphore, 0, vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+      imageWaited = true;
+    }
+
+    batchValues[i] = batchTimeline.nextSignalValue();
+
+    std::vector<vk::SemaphoreSubmitInfo> signals{
+      vk::SemaphoreSubmitInfo(batchTimeline.getSemaphore(), batchValues[i], vk::PipelineStageFlagBits2::eAllCommands)
+    };
+
+    // The graph always ends on the graphics queue, present waits on it.
+    if (i + 1 == batches.size() && !offscreen) {
+      signals.emplace_back(swapchain.getRenderFinishedSemaphore(imageIndex), 0, vk::PipelineStageFlagBits2::eAllCommands);
+    }
+
+    vk::CommandBufferSubmitInfo commandBufferInfo(commandBuffer);
+
+    vk::SubmitInfo2 submitInfo(
+      {},
+      waits,
+      commandBufferInfo,
+      signals
+    );
+
+    try {
+
+      (compute ? computeQueue : graphicsQueue).getQueue().submit2(submitInfo);
+
+    } catch (vk::SystemError& e) {
+      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while " << (compute ? "compute" : "graphics") << " queue submission: " << e.what();
+      return StatusCode::queueSubmitError;
+    }
+
+    batchTimeline.markSubmitted(batchValues[i]);
+
+    if (compute) {
+      frame.computeTimelineValue = batchValues[i];
+    } else {
+      frame.timelineValue = batchValues[i];
+    }
+  }
+
+  return StatusCode::success;
+}
+
+void Renderer::recordDraws(vk::CommandBuffer commandBuffer, vk::Extent2D extent, const Pipeline& pipeline) {
+
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.getPipeline());
+
+  vk::Viewport viewport(
+    0.0f,
+    0.0f,
+    static_cast<float>(extent.width),
+    static_cast<float>(extent.height),
+    0.0f,
+    1.0f
+  );
+
+  commandBuffer.setViewport(0, 1, &viewport);
+
+  vk::Rect2D scissor(
+    {0,0},
+    extent
+  );
+
+  commandBuffer.setScissor(0, 1, &scissor);
+
+  bindlessTable.bind(commandBuffer, vk::PipelineBindPoint::eGraphics, pipeline.getPipelineLayout());
+
+  DrawConstants constants{glm::vec4(0.0f, 0.0f, 1.0f, 0.0f)};
+  uniformRing.setConstants(commandBuffer, vk::PipelineBindPoint::eGraphics, pipeline.getPipelineLayout(), 1, &constants, sizeof(constants));
+
+  geometryBuffer.bind(commandBuffer);
+  geometryBuffer.draw(commandBuffer, triangle);
 }
 
+void Renderer::drawFrame() {
+
+  // Only the resources of the frame being recorded are waited on, so the GPU
+  // keeps executing the previous frames while this one is recorded.
+  FrameResources& frame = commandPool.getFrame(currentFrame);
+
+  // The present policy may allow fewer queued frames than there are frames
+  // in flight, trading throughput for latency.
+  uint32_t framesInFlight = commandPool.getFramesInFlight();
+  uint64_t waitValue = frame.timelineValue;
+
+  if (presentPolicy.maxQueuedFrames < framesInFlight) {
+    uint32_t queuedLimitFrame = (currentFrame + framesInFlight - presentPolicy.maxQueuedFrames) % framesInFlight;
+    waitValue = std::max(waitValue, commandPool.getFrame(queuedLimitFrame).timelineValue);
+  }
+
+  if (timeline.wait(waitValue) != StatusCode::success
+    || computeTimeline.wait(frame.computeTimelineValue) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't wait for frame " << currentFrame << ".";
+    return;
+  }
+
+  timeline.collect();
+  computeTimeline.collect();
+  uploadEngine.collect();
+
+  if (recorder.beginFrame(currentFrame) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't reset recording pools of frame " << currentFrame << ".";
+    return;
+  }
+
+  if (descriptorAllocator.beginFrame(currentFrame) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't reset descriptor pools of frame " << currentFrame << ".";
+    return;
+  }
+
+  if (uniformRing.beginFrame(currentFrame) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't allocate uniform ring set of frame " << currentFrame << ".";
+    return;
+  }
+
+  if (mainWindow && mainWindow->checkResized()) {
+    swapchainOutdated = true;
+  }
+
+  if (swapchainOutdated && recreateSwapchain() != StatusCode::success) {
+    return;
+  }
+
+  latencyTracker.acquireStarted();
+
+  uint32_t imageIndex;
+  vk::Result acquireResult = swapchain.acquireNextImage(frame.imageAvailableSemaphore, imageIndex);
+
+  if (acquireResult == vk::Result::eErrorOutOfDateKHR) {
+    if (recreateSwapchain() != StatusCode::success) {
+      return;
+    }
+    acquireResult = swapchain.acquireNextImage(frame.imageAvailableSemaphore, imageIndex);
+  }
+
+  if (acquireResult != vk::Result::eSuccess && acquireResult != vk::Result::eSuboptimalKHR) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't acquire swapchain image: " << vk::to_string(acquireResult);
+    return;
+  }
+
+  if (buildRenderGraph(imageIndex) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't build render graph.";
+    return;
+  }
+
+  if (uploadEngine.flush() != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't flush uploads.";
+    return;
+  }
+
+  if (submitRenderGraph(frame, imageIndex) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't submit frame.";
+    return;
+  }
+
+  vk::Result presentResult = swapchain.present(imageIndex);
+
+  latencyTracker.presented();
+
+  if (presentResult == vk::Result::eErrorOutOfDateKHR || presentResult == vk::Result::eSuboptimalKHR) {
+    swapchainOutdated = true;
+  } else if (presentResult != vk::Result::eSuccess) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't present swapchain image: " << vk::to_string(presentResult);
+  }
+
+  currentFrame = (currentFrame + 1) % commandPool.getFramesInFlight();
+}
+
+StatusCode Renderer::recreateSwapchain() {
+
+  vk::Extent2D extent = getFramebufferExtent();
+
+  //A minimized window has no area to render to, the swapchain is kept
+  //until it comes back.
+  if (extent.width == 0 || extent.height == 0) {
+    swapchainOutdated = true;
+    return StatusCode::swapchainCreationError;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "Recreating swapchain with extent " << extent.width << "x" << extent.height << ".";
+
+  StatusCode result = swapchain.recreate(extent, renderPass, timeline);
+
+  //Cached streams reference the old framebuffers and extent.
+  staticCommandCache.invalidateAll(timeline);
+
+  swapchainOutdated = result != StatusCode::success;
+
+  return result;
+}
+
+#ifdef BENPU_SHADER_HOT_RELOAD
+void Renderer::swapReloadedPipelines() {
+
+  std::vector<ShaderReloader::Shader> reloaded = shaderReloader.takeReloaded();
+
+  for (const ShaderReloader::Shader& shader : reloaded) {
+    pipelineRegistry.reload(shader.name, shader.code, timeline);
+  }
+
+  if (!reloaded.empty()) {
+    reloadedTrianglePipeline = pipelineRegistry.get(triangleDescription);
+  }
+
+  //The running pipeline stays in use until the rebuilt one is ready.
+  if (!reloadedTrianglePipeline.valid() || reloadedTrianglePipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return;
+  }
+
+  std::shared_ptr<Pipeline> pipeline = reloadedTrianglePipeline.get();
+  std::shared_ptr<Pipeline> previous = PipelineCompiler::resolve(trianglePipeline);
+
+  if (pipeline && pipeline != previous) {
+    trianglePipeline = reloadedTrianglePipeline;
+
+    //Cached streams have the old pipeline bound.
+    staticCommandCache.invalidateAll(timeline);
+
+    if (previous) {
+      timeline.retire(timeline.getLastSubmittedValue(), [this, previous]() {
+        device.destroyPipeline(previous->getPipeline());
+      });
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "Swapped in reloaded triangle pipeline.";
+  }
+
+  reloadedTrianglePipeline = PipelineFuture();
+}
+#endif
+
 Renderer::~Renderer() {
 
 }
@@ -1,16 +1,35 @@
 #ifndef BENPU_RENDERER_H_
 #define BENPU_RENDERER_H_
 
+#include <memory>
 #include <optional>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
+#include "core/utils/thread_pool.h"
+#include "render/vulkan/bindless_table.h"
 #include "render/vulkan/command_pool.h"
+#include "render/vulkan/descriptor_allocator.h"
+#include "render/vulkan/geometry_buffer.h"
 #include "render/vulkan/window.h"
 #include "render/vulkan/swapchain.h"
+#include "render/vulkan/memory_allocator.h"
+#include "render/vulkan/parallel_recorder.h"
 #include "render/vulkan/pipeline.h"
+#include "render/vulkan/pipeline_cache.h"
+#include "render/vulkan/pipeline_compiler.h"
+#include "render/vulkan/pipeline_registry.h"
+#include "render/vulkan/present_policy.h"
 #include "render/vulkan/queue.h"
+#include "render/vulkan/render_graph.h"
 #include "render/vulkan/render_pass.h"
+#ifdef BENPU_SHADER_HOT_RELOAD
+#include "render/vulkan/shader_reloader.h"
+#endif
+#include "render/vulkan/static_command_cache.h"
+#include "render/vulkan/timeline.h"
+#include "render/vulkan/uniform_ring.h"
+#include "render/vulkan/upload_engine.h"
 
 namespace benpu {
 
@@ -24,14 +43,48 @@ public:
 private:
   Renderer();
   ~Renderer();
-  Window mainWindow;
+  std::unique_ptr<Window> mainWindow;
+  bool headless = false;
+  bool headlessSurface = false;
+  bool dynamicRendering = true;
+  bool asyncCompute = true;
+  bool computeQueueAvailable = false;
+  bool staticCommands = true;
   vk::Instance instance = nullptr;
   vk::PhysicalDevice physicalDevice = nullptr;
   vk::Device device = nullptr;
+  MemoryAllocator memoryAllocator;
+  BindlessTable bindlessTable;
+  DescriptorAllocator descriptorAllocator;
+  UniformRing uniformRing;
+  Queue graphicsQueue;
+  Queue computeQueue;
+  PresentPolicy presentPolicy;
+  PresentLatencyTracker latencyTracker;
   Swapchain swapchain;
-  Pipeline pipeline;
+  PipelineCache pipelineCache;
+  PipelineCompiler pipelineCompiler;
+  PipelineRegistry pipelineRegistry;
+  PipelineDescription triangleDescription;
+  PipelineFuture trianglePipeline;
+#ifdef BENPU_SHADER_HOT_RELOAD
+  ShaderReloader shaderReloader;
+  PipelineFuture reloadedTrianglePipeline;
+#endif
   RenderPass renderPass;
+  RenderGraph renderGraph;
   CommandPool commandPool;
+  CommandPool computeCommandPool;
+  UploadEngine uploadEngine;
+  GeometryBuffer geometryBuffer;
+  Mesh triangle;
+  std::unique_ptr<ThreadPool> threadPool;
+  ParallelRecorder recorder;
+  StaticCommandCache staticCommandCache;
+  Timeline timeline;
+  Timeline computeTimeline;
+  uint32_t currentFrame = 0;
+  bool swapchainOutdated = false;
 
   ObjectStatus status = unitialized;
 
@@ -39,11 +92,22 @@ private:
 private:
 
   StatusCode createVulkanInstance();
+  StatusCode createSurface();
   StatusCode pickPhysicalDevice(QueueFamilyIndices& queueFamilyIndices, const std::vector<const char*>& requiredExtensions);
   StatusCode createDevice(QueueFamilyIndices& queueFamilyIndices, const std::vector<const char*>& requiredExtensions);
   int getBestPhysicalDevice(const std::vector<vk::PhysicalDevice>& physicalDevices, QueueFamilyIndices& bestDeviceQueueFamilyIndices, const std::vector<const char*>& requiredExtensions);
 
+  vk::Extent2D getFramebufferExtent() const;
+  bool shouldClose() const;
+  StatusCode buildRenderGraph(uint32_t imageIndex);
+  StatusCode recordBatch(vk::CommandBuffer commandBuffer, uint32_t batchIndex, bool acquireUploads);
+  StatusCode submitRenderGraph(FrameResources& frame, uint32_t imageIndex);
+  void recordDraws(vk::CommandBuffer commandBuffer, vk::Extent2D extent, const Pipeline& pipeline);
+  StatusCode recreateSwapchain();
   void drawFrame();
+#ifdef BENPU_SHADER_HOT_RELOAD
+  void swapReloadedPipelines();
+#endif
 };
 
 } //namespace benpu
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <boost/log/trivial.hpp>
+#include <shaderc/shaderc.hpp>
+
+#include "render/vulkan/shader_reloader.h"
+
+namespace benpu {
+
+static bool readText(const std::filesystem::path& path, std::string& text) {
+  std::ifstream file(path);
+
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::stringstream stream;
+  stream << file.rdbuf();
+  text = stream.str();
+
+  return true;
+}
+
+static bool isStage(const std::filesystem::path& path) {
+  return path.extension() == ".vert" || path.extension() == ".frag";
+}
+
+// Resolves #include against the shader directory, like glslc does for the
+// build time compilation.
+class ShaderIncluder: public shaderc::CompileOptions::IncluderInterface {
+public:
+  ShaderIncluder(const std::filesystem::path& directory): directory{directory} {
+
+  }
+
+  shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type, const char*, size_t) override {
+    auto include = new Include;
+    std::filesystem::path path = directory / requestedSource;
+
+    //An empty name tells shaderc the include failed, content is the error.
+    if (readText(path, include->content)) {
+      include->name = path.string();
+    } else {
+      include->content = "Couldn't open " + path.string() + ".";
+    }
+
+    include->result = {
+      include->name.c_str(),
+      include->name.size(),
+      include->content.c_str(),
+      include->content.size(),
+      include
+    };
+
+    return &include->result;
+  }
+
+  void ReleaseInclude(shaderc_include_result* result) override {
+    delete static_cast<Include*>(result->user_data);
+  }
+
+private:
+  struct Include {
+    std::string name;
+    std::string content;
+    shaderc_include_result result;
+  };
+
+  std::filesystem::path directory;
+};
+
+ShaderReloader::~ShaderReloader() {
+
+  stopping = true;
+
+  if (watcher.joinable()) {
+    watcher.join();
+  }
+
+  if (inotifyDescriptor >= 0) {
+    close(inotifyDescriptor);
+  }
+}
+
+StatusCode ShaderReloader::initialize(const std::filesystem::path& sourceDirectory) {
+
+  BOOST_LOG_TRIVIAL(info) << "Watching " << sourceDirectory << " for shader changes.";
+
+  this->sourceDirectory = sourceDirectory;
+
+  inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if (inotifyDescriptor < 0) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create inotify instance.";
+    return StatusCode::shaderWatchError;
+  }
+
+  //Editors either rewrite the file in place or move a new one over it.
+  if (inotify_add_watch(inotifyDescriptor, sourceDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't watch " << sourceDirectory << ".";
+    return StatusCode::shaderWatchError;
+  }
+
+  watcher = std::thread(&ShaderReloader::watch, this);
+
+  return StatusCode::success;
+}
+
+std::vector<ShaderReloader::Shader> ShaderReloader::takeReloaded() {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::vector<Shader> result;
+  result.swap(reloaded);
+
+  return result;
+}
+
+void ShaderReloader::watch() {
+
+  alignas(inotify_event) char buffer[4096];
+
+  while (!stopping) {
+    pollfd descriptor{inotifyDescriptor, POLLIN, 0};
+
+    //Timeout bounds how long the destructor waits for the thread.
+    if (poll(&descriptor, 1, 200) <= 0) {
+      continue;
+    }
+
+    std::set<std::filesystem::path> changed;
+    ssize_t length;
+
+    while ((length = read(inotifyDescriptor, buffer, sizeof(buffer))) > 0) {
+      for (char* current = buffer; current < buffer + length;) {
+        auto event = reinterpret_cast<inotify_event*>(current);
+
+        if (event->len > 0) {
+          changed.insert(sourceDirectory / event->name);
+        }
+
+        current += sizeof(inotify_event) + event->len;
+      }
+    }
+
+    std::set<std::filesystem::path> stages;
+
+    for (const std::filesystem::path& path : changed) {
+      if (isStage(path)) {
+        stages.insert(path);
+      } else if (path.extension() == ".glsl") {
+        //Any stage may include it, rebuild them all.
+        for (const auto& entry : std::filesystem::directory_iterator(sourceDirectory)) {
+          if (isStage(entry.path())) {
+            stages.insert(entry.path());
+          }
+        }
+      }
+    }
+
+    for (const std::filesystem::path& stage : stages) {
+      compile(stage);
+    }
+  }
+}
+
+StatusCode ShaderReloader::compile(const std::filesystem::path& source) {
+
+  std::string text;
+
+  if (!readText(source, text)) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't open shader " << source << ".";
+    return StatusCode::fileCouldntBeOpened;
+  }
+
+  shaderc::Compiler compiler;
+  shaderc::CompileOptions options;
+  options.SetIncluder(std::make_unique<ShaderIncluder>(sourceDirectory));
+
+  shaderc_shader_kind kind = source.extension() == ".vert" ? shaderc_vertex_shader : shaderc_fragment_shader;
+  std::string name = source.filename().string();
+
+  shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(text, kind, name.c_str(), options);
+
+  //A broken shader keeps the running pipeline, fix it and save again.
+  if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't compile shader " << name << ":\n" << result.GetErrorMessage();
+    return StatusCode::shaderModuleCreationError;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "Recompiled shader " << name << ".";
+
+  Shader shader{name + ".spv", std::vector<uint32_t>(result.cbegin(), result.cend())};
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  //Saved twice before the renderer picked it up, the latest code wins.
+  auto found = std::find_if(reloaded.begin(), reloaded.end(), [&shader](const Shader& candidate) {
+    return candidate.name == shader.name;
+  });
+
+  if (found != reloaded.end()) {
+    *found = std::move(shader);
+  } else {
+    reloaded.push_back(std::move(shader));
+  }
+
+  return StatusCode::success;
+}
+
+} //namespace benpu
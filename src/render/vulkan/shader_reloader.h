@@ -0,0 +1,55 @@
+#ifndef BENPU_SHADER_RELOADER_H_
+#define BENPU_SHADER_RELOADER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "status_code.h"
+
+namespace benpu {
+
+// Development helper, only built with BENPU_SHADER_HOT_RELOAD. Watches the
+// GLSL sources with inotify and recompiles changed stages with shaderc on a
+// background thread. The renderer collects the new SPIR-V at a frame
+// boundary and hands it to the pipeline registry in place of the embedded
+// code.
+class ShaderReloader {
+public:
+  struct Shader {
+    // Same name as the embedded SPIR-V, e.g. "first.vert.spv".
+    std::string name;
+    std::vector<uint32_t> code;
+  };
+
+  ShaderReloader() = default;
+  ~ShaderReloader();
+
+  ShaderReloader(const ShaderReloader&) = delete;
+  ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+  StatusCode initialize(const std::filesystem::path& sourceDirectory);
+
+  // Shaders recompiled since the last call.
+  std::vector<Shader> takeReloaded();
+
+private:
+  std::filesystem::path sourceDirectory;
+  int inotifyDescriptor = -1;
+  std::thread watcher;
+  std::atomic<bool> stopping{false};
+  std::mutex mutex;
+  std::vector<Shader> reloaded;
+
+private:
+  void watch();
+  StatusCode compile(const std::filesystem::path& source);
+};
+
+} //namespace benpu
+
+#endif
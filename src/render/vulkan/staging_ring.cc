@@ -0,0 +1,133 @@
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/staging_ring.h"
+
+namespace benpu {
+
+StagingRing::StagingRing(vk::Device& device, MemoryAllocator& memoryAllocator): device{device}, memoryAllocator{memoryAllocator} {
+
+}
+
+StatusCode StagingRing::initialize(vk::DeviceSize capacity) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating staging ring of " << capacity << " bytes.";
+
+  return createBlock(capacity, current);
+}
+
+StatusCode StagingRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment, Allocation& allocation) {
+
+  //The ring never hands out empty ranges, they would look like a full ring.
+  if (size == 0) {
+    BOOST_LOG_TRIVIAL(error) << "Empty staging allocation requested.";
+    return StatusCode::memoryAllocationError;
+  }
+
+  std::optional<uint64_t> offset = current.allocator.allocate(size, alignment);
+
+  if (!offset.has_value()) {
+    Block block;
+
+    if (size > current.allocator.getCapacity() / 4) {
+      // Oversized requests would keep evicting everything else from the
+      // ring, they get a block of their own that is retired right away.
+      BOOST_LOG_TRIVIAL(debug) << "Dedicated staging allocation of " << size << " bytes.";
+
+      if (createBlock(size, block) != StatusCode::success) {
+        return StatusCode::memoryAllocationError;
+      }
+
+      offset = block.allocator.allocate(size, 1);
+      retiredBlocks.push_back(block);
+
+      if (!offset.has_value()) {
+        return StatusCode::memoryAllocationError;
+      }
+
+      allocation = {block.buffer, offset.value(), block.mapped};
+
+      return StatusCode::success;
+    }
+
+    vk::DeviceSize capacity = current.allocator.getCapacity() * 2;
+
+    BOOST_LOG_TRIVIAL(info) << "Staging ring is full, growing it to " << capacity << " bytes.";
+
+    if (createBlock(capacity, block) != StatusCode::success) {
+      return StatusCode::memoryAllocationError;
+    }
+
+    // The old ring lives until everything allocated from it has retired.
+    current.fenced = false;
+    retiredBlocks.push_back(current);
+    current = block;
+
+    offset = current.allocator.allocate(size, alignment);
+
+    if (!offset.has_value()) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't allocate " << size << " bytes from the grown staging ring.";
+      return StatusCode::memoryAllocationError;
+    }
+  }
+
+  allocation = {current.buffer, offset.value(), current.mapped + offset.value()};
+
+  return StatusCode::success;
+}
+
+void StagingRing::retire(uint64_t value) {
+
+  current.allocator.retire(value);
+
+  for (Block& block : retiredBlocks) {
+    if (!block.fenced) {
+      block.releaseValue = value;
+      block.fenced = true;
+    }
+  }
+}
+
+void StagingRing::reclaim(uint64_t completedValue) {
+
+  current.allocator.reclaim(completedValue);
+
+  auto released = std::partition(retiredBlocks.begin(), retiredBlocks.end(), [completedValue](const Block& block) {
+    return !block.fenced || block.releaseValue > completedValue;
+  });
+
+  for (auto block = released; block != retiredBlocks.end(); ++block) {
+    destroyBlock(*block);
+  }
+
+  retiredBlocks.erase(released, retiredBlocks.end());
+}
+
+StatusCode StagingRing::createBlock(vk::DeviceSize capacity, Block& block) {
+
+  StatusCode result = memoryAllocator.createBuffer(
+    capacity,
+    vk::BufferUsageFlagBits::eTransferSrc,
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    block.buffer,
+    block.memory
+  );
+
+  if (result != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create staging buffer.";
+    return result;
+  }
+
+  block.mapped = static_cast<uint8_t*>(block.memory.mapped);
+  block.allocator = RingAllocator(capacity);
+
+  return StatusCode::success;
+}
+
+void StagingRing::destroyBlock(Block& block) {
+  memoryAllocator.destroyBuffer(block.buffer, block.memory);
+}
+
+} //namespace benpu
@@ -0,0 +1,57 @@
+#ifndef BENPU_STAGING_RING_H_
+#define BENPU_STAGING_RING_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/utils/ring_allocator.h"
+#include "render/vulkan/memory_allocator.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Host visible staging memory mapped for the lifetime of the ring. Callers
+// bump-allocate from it, the space comes back once the timeline value the
+// allocations were retired with has completed. A full ring is replaced by
+// one twice as large and requests too big for it get a dedicated buffer.
+class StagingRing {
+public:
+  struct Allocation {
+    vk::Buffer buffer = nullptr;
+    vk::DeviceSize offset = 0;
+    void* data = nullptr;
+  };
+
+  StagingRing(vk::Device& device, MemoryAllocator& memoryAllocator);
+
+  StatusCode initialize(vk::DeviceSize capacity);
+
+  StatusCode allocate(vk::DeviceSize size, vk::DeviceSize alignment, Allocation& allocation);
+  void retire(uint64_t value);
+  void reclaim(uint64_t completedValue);
+
+private:
+  struct Block {
+    vk::Buffer buffer = nullptr;
+    MemoryAllocation memory;
+    uint8_t* mapped = nullptr;
+    RingAllocator allocator;
+    uint64_t releaseValue = 0;
+    bool fenced = false;
+  };
+
+  vk::Device& device;
+  MemoryAllocator& memoryAllocator;
+  Block current;
+  std::vector<Block> retiredBlocks;
+
+private:
+  StatusCode createBlock(vk::DeviceSize capacity, Block& block);
+  void destroyBlock(Block& block);
+};
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,133 @@
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/static_command_cache.h"
+
+namespace benpu {
+
+StaticCommandCache::StaticCommandCache(vk::Device& device): device{device} {
+
+}
+
+StatusCode StaticCommandCache::initialize(const QueueFamilyIndices& queueFamilyIndices) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating static command pool.";
+
+  vk::CommandPoolCreateInfo poolInfo(
+    {},
+    queueFamilyIndices.graphicsFamily.value()
+  );
+
+  try {
+
+    commandPool = device.createCommandPool(poolInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while static command pool creation: " << e.what();
+    return StatusCode::commandPoolCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode StaticCommandCache::get(
+  const std::string& stream,
+  uint32_t slot,
+  const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+  const RecordCallback& callback,
+  vk::CommandBuffer& commandBuffer
+) {
+
+  std::vector<vk::CommandBuffer>& slots = streams[stream];
+
+  if (slot < slots.size() && slots[slot]) {
+    commandBuffer = slots[slot];
+    return StatusCode::success;
+  }
+
+  slots.resize(std::max<size_t>(slots.size(), slot + 1), nullptr);
+
+  vk::CommandBuffer recorded = nullptr;
+
+  try {
+
+    vk::CommandBufferAllocateInfo allocInfo(
+      commandPool,
+      vk::CommandBufferLevel::eSecondary,
+      1
+    );
+
+    recorded = device.allocateCommandBuffers(allocInfo).front();
+
+    // The same buffer is replayed by consecutive frames, which may still be
+    // pending when the next one is submitted.
+    vk::CommandBufferBeginInfo beginInfo(
+      vk::CommandBufferUsageFlagBits::eSimultaneousUse | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+      &inheritanceInfo
+    );
+
+    recorded.begin(beginInfo);
+    callback(recorded);
+    recorded.end();
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while static command buffer record: " << e.what();
+
+    //Never submitted, so it can go right away.
+    if (recorded) {
+      device.freeCommandBuffers(commandPool, recorded);
+    }
+
+    return StatusCode::commandBufferRecordError;
+  }
+
+  BOOST_LOG_TRIVIAL(debug) << "Recorded static command stream " << stream << " for slot " << slot << ".";
+
+  slots[slot] = recorded;
+  commandBuffer = recorded;
+
+  return StatusCode::success;
+}
+
+void StaticCommandCache::invalidate(const std::string& stream, Timeline& timeline) {
+
+  auto found = streams.find(stream);
+
+  if (found == streams.end()) {
+    return;
+  }
+
+  release(std::move(found->second), timeline);
+  streams.erase(found);
+}
+
+void StaticCommandCache::invalidateAll(Timeline& timeline) {
+
+  for (auto& [stream, slots] : streams) {
+    release(std::move(slots), timeline);
+  }
+
+  streams.clear();
+}
+
+void StaticCommandCache::release(std::vector<vk::CommandBuffer> commandBuffers, Timeline& timeline) {
+
+  commandBuffers.erase(std::remove(commandBuffers.begin(), commandBuffers.end(), vk::CommandBuffer()), commandBuffers.end());
+
+  if (commandBuffers.empty()) {
+    return;
+  }
+
+  // Submitted frames may still execute the old buffers.
+  vk::Device retiringDevice = device;
+  vk::CommandPool pool = commandPool;
+
+  timeline.retire(timeline.getLastSubmittedValue(), [retiringDevice, pool, commandBuffers]() {
+    retiringDevice.freeCommandBuffers(pool, commandBuffers);
+  });
+}
+
+} //namespace benpu
+
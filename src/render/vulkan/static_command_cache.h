@@ -0,0 +1,50 @@
+#ifndef BENPU_STATIC_COMMAND_CACHE_H_
+#define BENPU_STATIC_COMMAND_CACHE_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "render/vulkan/queue.h"
+#include "render/vulkan/timeline.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Secondary command buffers for streams that don't change between frames.
+// A stream is recorded once per slot (one slot per swapchain image or
+// attachment set) and replayed until it is invalidated.
+class StaticCommandCache {
+public:
+  using RecordCallback = std::function<void(vk::CommandBuffer)>;
+
+  StaticCommandCache(vk::Device& device);
+
+  StatusCode initialize(const QueueFamilyIndices& queueFamilyIndices);
+
+  StatusCode get(
+    const std::string& stream,
+    uint32_t slot,
+    const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+    const RecordCallback& callback,
+    vk::CommandBuffer& commandBuffer
+  );
+
+  void invalidate(const std::string& stream, Timeline& timeline);
+  void invalidateAll(Timeline& timeline);
+
+private:
+  vk::Device& device;
+  vk::CommandPool commandPool = nullptr;
+  std::unordered_map<std::string, std::vector<vk::CommandBuffer>> streams;
+
+private:
+  void release(std::vector<vk::CommandBuffer> commandBuffers, Timeline& timeline);
+};
+
+} //namespace benpu
+
+#endif
@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include <boost/log/trivial.hpp>
 
 #include "render/vulkan/window.h"
@@ -9,7 +11,6 @@ namespace benpu {
 
 Swapchain::Swapchain(vk::Device& device): 
   device{device},
-  graphicsQueue{device},
   presentationQueue{device} {
 
 }
@@ -25,21 +26,20 @@ vk::SurfaceFormatKHR Swapchain::chooseSwapSurfaceFormat(const std::vector<vk::Su
 
 vk::PresentModeKHR Swapchain::chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) {
   for (const auto& availablePresentMode : availablePresentModes) {
-    if (availablePresentMode == vk::PresentModeKHR::eMailbox) {
+    if (availablePresentMode == presentPolicy.presentMode) {
       return availablePresentMode;
     }
   }
+
+  BOOST_LOG_TRIVIAL(warning) << "Present mode " << vk::to_string(presentPolicy.presentMode) << " isn't supported, falling back to FIFO.";
   return vk::PresentModeKHR::eFifo;
 }
 
-vk::Extent2D Swapchain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, const Window& window){
+vk::Extent2D Swapchain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, vk::Extent2D requestedExtent){
   if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
     return capabilities.currentExtent;
   } else {
-    auto [width, height] = window.getFramebufferSize();
-
-    vk::Extent2D actualExtent = {static_cast<uint32_t>(width),
-                                static_cast<uint32_t>(height)};
+    vk::Extent2D actualExtent = requestedExtent;
 
     actualExtent.width =
         std::clamp(actualExtent.width, capabilities.minImageExtent.width,
@@ -52,18 +52,69 @@ vk::Extent2D Swapchain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capab
   }
 }
 
-StatusCode Swapchain::initialize(vk::PhysicalDevice& physicalDevice, const QueueFamilyIndices& queueFamilyIndices, const Window& window) {
-  try {
-    
-    if(graphicsQueue.initialize(queueFamilyIndices.graphicsFamily.value()) != StatusCode::success) {
-      BOOST_LOG_TRIVIAL(error) << "Couldn't create graphics queue.";
-      return StatusCode::queueCreationError;
+StatusCode Swapchain::initialize(vk::PhysicalDevice& physicalDevice, const QueueFamilyIndices& queueFamilyIndices, vk::Extent2D requestedExtent, const PresentPolicy& presentPolicy) {
+
+  this->physicalDevice = physicalDevice;
+  this->queueFamilyIndices = queueFamilyIndices;
+  this->presentPolicy = presentPolicy;
+
+  if(presentationQueue.initialize(queueFamilyIndices.presentFamily.value()) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create presentiation queue.";
+    return StatusCode::queueCreationError;
+  }
+
+  return createSwapchain(requestedExtent, nullptr);
+}
+
+StatusCode Swapchain::recreate(vk::Extent2D requestedExtent, const RenderPass& renderPass, Timeline& timeline) {
+
+  if (offscreen) {
+    return StatusCode::success;
+  }
+
+  // The old swapchain keeps being presented from and its image views and
+  // framebuffers may still be used by frames in flight, so they are only
+  // destroyed once the last submitted frame has completed.
+  vk::Device retiringDevice = device;
+  vk::SwapchainKHR oldSwapchain = swapchain;
+  std::vector<vk::ImageView> oldImageViews = std::move(swapChainImageViews);
+  std::vector<vk::Framebuffer> oldFramebuffers = std::move(swapChainFramebuffers);
+  std::vector<vk::Semaphore> oldSemaphores = std::move(renderFinishedSemaphores);
+
+  swapChainImageViews.clear();
+  swapChainFramebuffers.clear();
+  renderFinishedSemaphores.clear();
+
+  StatusCode result = createSwapchain(requestedExtent, oldSwapchain);
+
+  timeline.retire(timeline.getLastSubmittedValue(), [retiringDevice, oldSwapchain, oldImageViews, oldFramebuffers, oldSemaphores]() {
+    for (vk::Semaphore semaphore : oldSemaphores) {
+      retiringDevice.destroySemaphore(semaphore);
+    }
+    for (vk::Framebuffer framebuffer : oldFramebuffers) {
+      retiringDevice.destroyFramebuffer(framebuffer);
     }
-    
-    if(presentationQueue.initialize(queueFamilyIndices.presentFamily.value()) != StatusCode::success) {
-      BOOST_LOG_TRIVIAL(error) << "Couldn't create presentiation queue.";
-      return StatusCode::queueCreationError;
+    for (vk::ImageView imageView : oldImageViews) {
+      retiringDevice.destroyImageView(imageView);
     }
+    retiringDevice.destroySwapchainKHR(oldSwapchain);
+  });
+
+  if (result != StatusCode::success) {
+    swapchain = nullptr;
+    return result;
+  }
+
+  // With dynamic rendering there is no render pass and no framebuffers.
+  if (!renderPass.getRenderPass()) {
+    return StatusCode::success;
+  }
+
+  return createFramebuffers(renderPass);
+}
+
+StatusCode Swapchain::createSwapchain(vk::Extent2D requestedExtent, vk::SwapchainKHR oldSwapchain) {
+  try {
 
     BOOST_LOG_TRIVIAL(info) << "Creating swapchain.";
 
@@ -71,13 +122,15 @@ StatusCode Swapchain::initialize(vk::PhysicalDevice& physicalDevice, const Queue
 
     vk::SurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(supportDetails.formats);
     vk::PresentModeKHR presentMode = chooseSwapPresentMode(supportDetails.presentModes);
-    extent = chooseSwapExtent(supportDetails.capabilities, window);
+    extent = chooseSwapExtent(supportDetails.capabilities, requestedExtent);
 
-    uint32_t imageCount = supportDetails.capabilities.minImageCount;
+    uint32_t imageCount = std::max(presentPolicy.imageCount, supportDetails.capabilities.minImageCount);
     if (supportDetails.capabilities.maxImageCount > 0 && imageCount > supportDetails.capabilities.maxImageCount) {
       imageCount = supportDetails.capabilities.maxImageCount;
     }
 
+    BOOST_LOG_TRIVIAL(info) << "Using present mode " << vk::to_string(presentMode) << " with " << imageCount << " images.";
+
     uint32_t queueFamilyIndicesArray[] = {queueFamilyIndices.graphicsFamily.value(), queueFamilyIndices.presentFamily.value()};
 
     vk::SwapchainCreateInfoKHR createInfo(
@@ -90,18 +143,19 @@ StatusCode Swapchain::initialize(vk::PhysicalDevice& physicalDevice, const Queue
       1,
       vk::ImageUsageFlagBits::eColorAttachment,
       vk::SharingMode::eConcurrent,
-      1,
+      2,
       queueFamilyIndicesArray,
       supportDetails.capabilities.currentTransform,
       vk::CompositeAlphaFlagBitsKHR::eInherit,
       presentMode,
-      vk::True
+      vk::True,
+      oldSwapchain
     );
 
     if (queueFamilyIndices.graphicsFamily == queueFamilyIndices.presentFamily) {
       createInfo.setImageSharingMode(vk::SharingMode::eExclusive);
-      createInfo.setQueueFamilyIndexCount(2);
-      createInfo.setQueueFamilyIndices(queueFamilyIndicesArray);
+      createInfo.setQueueFamilyIndexCount(0);
+      createInfo.setPQueueFamilyIndices(nullptr);
     }
 
     swapchain = device.createSwapchainKHR(createInfo);
@@ -119,6 +173,51 @@ StatusCode Swapchain::initialize(vk::PhysicalDevice& physicalDevice, const Queue
     return StatusCode::imageViewsCreationError;
   }
 
+  return createRenderFinishedSemaphores();
+}
+
+StatusCode Swapchain::initializeOffscreen(MemoryAllocator& memoryAllocator, vk::Extent2D requestedExtent, uint32_t imageCount) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating " << imageCount << " offscreen color images.";
+
+  offscreen = true;
+  imageFormat = vk::Format::eB8G8R8A8Srgb;
+  extent = requestedExtent;
+
+  for (uint32_t i = 0; i < imageCount; ++i) {
+    vk::ImageCreateInfo imageInfo(
+      {},
+      vk::ImageType::e2D,
+      imageFormat,
+      vk::Extent3D(extent.width, extent.height, 1),
+      1,
+      1,
+      vk::SampleCountFlagBits::e1,
+      vk::ImageTiling::eOptimal,
+      vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+      vk::SharingMode::eExclusive,
+      0,
+      nullptr,
+      vk::ImageLayout::eUndefined
+    );
+
+    vk::Image image;
+    MemoryAllocation allocation;
+
+    if (memoryAllocator.createImage(imageInfo, vk::MemoryPropertyFlagBits::eDeviceLocal, image, allocation) != StatusCode::success) {
+      BOOST_LOG_TRIVIAL(error) << "Couldn't allocate device local memory for offscreen images.";
+      return StatusCode::swapchainCreationError;
+    }
+
+    swapChainImages.push_back(image);
+    offscreenImageAllocations.push_back(allocation);
+  }
+
+  if(createImageViews() != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create image views.";
+    return StatusCode::imageViewsCreationError;
+  }
+
   return StatusCode::success;
 }
 
@@ -159,6 +258,22 @@ StatusCode Swapchain::createImageViews() {
   return StatusCode::success;
 }
 
+StatusCode Swapchain::createRenderFinishedSemaphores() {
+
+  vk::SemaphoreCreateInfo sCreateInfo;
+
+  renderFinishedSemaphores.resize(swapChainImages.size());
+
+  for (vk::Semaphore& semaphore : renderFinishedSemaphores) {
+    if (device.createSemaphore(&sCreateInfo, nullptr, &semaphore) != vk::Result::eSuccess) {
+      BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while render semaphore creation.";
+      return StatusCode::semaphoreCreationError;
+    }
+  }
+
+  return StatusCode::success;
+}
+
 StatusCode Swapchain::createFramebuffers(const RenderPass& renderPass) {
 
   BOOST_LOG_TRIVIAL(info) << "Creating framebuffers.";
@@ -206,6 +321,56 @@ StatusCode Swapchain::setSurface(vk::Instance& instance, Window& window) {
   return StatusCode::success;
 }
 
+StatusCode Swapchain::setHeadlessSurface(vk::Instance& instance) {
+  try {
+    vk::DispatchLoaderDynamic dispatcher(instance, vkGetInstanceProcAddr);
+    vk::HeadlessSurfaceCreateInfoEXT createInfo;
+
+    surface = instance.createHeadlessSurfaceEXT(createInfo, nullptr, dispatcher);
+  } catch (const vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while headless surface creation: " << e.what();
+    return StatusCode::vulkanError;
+  }
+  return StatusCode::success;
+}
+
+vk::Result Swapchain::acquireNextImage(vk::Semaphore imageAvailableSemaphore, uint32_t& imageIndex) {
+
+  // Offscreen images are handed out in the same order as the frames in
+  // flight, so an image is only reused once its frame has been waited on.
+  if (offscreen) {
+    imageIndex = nextOffscreenImage;
+    nextOffscreenImage = (nextOffscreenImage + 1) % static_cast<uint32_t>(swapChainImages.size());
+    return vk::Result::eSuccess;
+  }
+
+  return device.acquireNextImageKHR(
+    swapchain,
+    std::numeric_limits<uint64_t>::max(),
+    imageAvailableSemaphore,
+    nullptr,
+    &imageIndex
+  );
+}
+
+vk::Result Swapchain::present(uint32_t imageIndex) {
+
+  if (offscreen) {
+    return vk::Result::eSuccess;
+  }
+
+  vk::PresentInfoKHR presentInfo(
+    1,
+    &renderFinishedSemaphores[imageIndex],
+    1,
+    &swapchain,
+    &imageIndex,
+    nullptr
+  );
+
+  return presentationQueue.getQueue().presentKHR(&presentInfo);
+}
+
 vk::SurfaceKHR Swapchain::getSurface() const {
   return surface;
 }
@@ -214,6 +379,30 @@ vk::Format Swapchain::getFormat() const {
   return imageFormat;
 }
 
+vk::Extent2D Swapchain::getExtent() const {
+  return extent;
+}
+
+vk::Image Swapchain::getImage(uint32_t imageIndex) const {
+  return swapChainImages[imageIndex];
+}
+
+vk::ImageView Swapchain::getImageView(uint32_t imageIndex) const {
+  return swapChainImageViews[imageIndex];
+}
+
+vk::Framebuffer Swapchain::getFramebuffer(uint32_t imageIndex) const {
+  return swapChainFramebuffers[imageIndex];
+}
+
+vk::Semaphore Swapchain::getRenderFinishedSemaphore(uint32_t imageIndex) const {
+  return renderFinishedSemaphores[imageIndex];
+}
+
+bool Swapchain::isOffscreen() const {
+  return offscreen;
+}
+
 SwapChainSupportDetails Swapchain::querySwapChainSupport(vk::PhysicalDevice physicalDevice) {
 
   supportDetails.formats = physicalDevice.getSurfaceFormatsKHR(surface);
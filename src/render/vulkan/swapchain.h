@@ -5,8 +5,12 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include "render/vulkan/memory_allocator.h"
+#include "render/vulkan/present_policy.h"
 #include "render/vulkan/queue.h"
 #include "render/vulkan/render_pass.h"
+#include "render/vulkan/timeline.h"
+#include "render/vulkan/window.h"
 #include "status_code.h"
 
 namespace benpu {
@@ -22,18 +26,33 @@ public:
   Swapchain(vk::Device& device);
 
   StatusCode setSurface(vk::Instance &instance, Window &window);
+  StatusCode setHeadlessSurface(vk::Instance &instance);
 
-  StatusCode initialize(vk::PhysicalDevice& physicalDevice, const QueueFamilyIndices& queueFamilyIndices, const Window& window);
+  StatusCode initialize(vk::PhysicalDevice& physicalDevice, const QueueFamilyIndices& queueFamilyIndices, vk::Extent2D requestedExtent, const PresentPolicy& presentPolicy);
+  StatusCode initializeOffscreen(MemoryAllocator& memoryAllocator, vk::Extent2D requestedExtent, uint32_t imageCount);
   StatusCode createFramebuffers(const RenderPass& renderPass);
+  StatusCode recreate(vk::Extent2D requestedExtent, const RenderPass& renderPass, Timeline& timeline);
+
+  vk::Result acquireNextImage(vk::Semaphore imageAvailableSemaphore, uint32_t& imageIndex);
+  vk::Result present(uint32_t imageIndex);
 
   vk::SurfaceKHR getSurface() const;
   vk::Format getFormat() const;
+  vk::Extent2D getExtent() const;
+  vk::Image getImage(uint32_t imageIndex) const;
+  vk::ImageView getImageView(uint32_t imageIndex) const;
+  vk::Framebuffer getFramebuffer(uint32_t imageIndex) const;
+  vk::Semaphore getRenderFinishedSemaphore(uint32_t imageIndex) const;
+  bool isOffscreen() const;
 
   SwapChainSupportDetails querySwapChainSupport(vk::PhysicalDevice physicalDevice);
 
 private:
 
   vk::Device& device;
+  vk::PhysicalDevice physicalDevice = nullptr;
+  QueueFamilyIndices queueFamilyIndices;
+  PresentPolicy presentPolicy;
   vk::SurfaceKHR surface = nullptr;
   vk::SwapchainKHR swapchain = nullptr;
   std::vector<vk::Image> swapChainImages;
@@ -41,18 +60,23 @@ private:
   vk::Extent2D extent;
   std::vector<vk::ImageView> swapChainImageViews;
   std::vector<vk::Framebuffer> swapChainFramebuffers;
-  vk::Semaphore imageAvailableSemaphore = nullptr;
-  vk::Semaphore renderFinishedSemaphore = nullptr;
+  // One per image, a frame slot is reused before the present that waited on
+  // its previous semaphore is known to be done with it.
+  std::vector<vk::Semaphore> renderFinishedSemaphores;
+  std::vector<MemoryAllocation> offscreenImageAllocations;
+  uint32_t nextOffscreenImage = 0;
+  bool offscreen = false;
   Queue presentationQueue;
-  Queue graphicsQueue;
   SwapChainSupportDetails supportDetails;
-  
+
 
 private:
   vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
   vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
-  vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, const Window& window);
+  vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, vk::Extent2D requestedExtent);
+  StatusCode createSwapchain(vk::Extent2D requestedExtent, vk::SwapchainKHR oldSwapchain);
   StatusCode createImageViews();
+  StatusCode createRenderFinishedSemaphores();
   
 };
 
@@ -0,0 +1,116 @@
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/timeline.h"
+
+namespace benpu {
+
+Timeline::Timeline(vk::Device& device): device{device} {
+
+}
+
+StatusCode Timeline::initialize() {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating timeline semaphore.";
+
+  vk::SemaphoreTypeCreateInfo typeCreateInfo(
+    vk::SemaphoreType::eTimeline,
+    0
+  );
+
+  vk::SemaphoreCreateInfo createInfo(
+    {},
+    &typeCreateInfo
+  );
+
+  if (device.createSemaphore(&createInfo, nullptr, &semaphore) != vk::Result::eSuccess) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while timeline semaphore creation.";
+    return StatusCode::semaphoreCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+uint64_t Timeline::nextSignalValue() const {
+  return lastSubmittedValue + 1;
+}
+
+void Timeline::markSubmitted(uint64_t value) {
+  lastSubmittedValue = std::max(lastSubmittedValue, value);
+}
+
+uint64_t Timeline::getLastSubmittedValue() const {
+  return lastSubmittedValue;
+}
+
+uint64_t Timeline::getCompletedValue() {
+
+  if (completedValue == lastSubmittedValue) {
+    return completedValue;
+  }
+
+  uint64_t value = 0;
+
+  if (device.getSemaphoreCounterValue(semaphore, &value) == vk::Result::eSuccess) {
+    completedValue = std::max(completedValue, value);
+  }
+
+  return completedValue;
+}
+
+bool Timeline::isComplete(uint64_t value) {
+  return value <= completedValue || value <= getCompletedValue();
+}
+
+StatusCode Timeline::wait(uint64_t value, uint64_t timeout) {
+
+  if (isComplete(value)) {
+    return StatusCode::success;
+  }
+
+  vk::SemaphoreWaitInfo waitInfo(
+    {},
+    1,
+    &semaphore,
+    &value
+  );
+
+  vk::Result result = device.waitSemaphores(&waitInfo, timeout);
+
+  if (result != vk::Result::eSuccess) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't wait for timeline value " << value << ": " << vk::to_string(result);
+    return StatusCode::semaphoreWaitError;
+  }
+
+  completedValue = std::max(completedValue, value);
+
+  return StatusCode::success;
+}
+
+void Timeline::retire(uint64_t value, std::function<void()> destroy) {
+
+  if (isComplete(value)) {
+    destroy();
+    return;
+  }
+
+  retired.emplace(value, std::move(destroy));
+}
+
+void Timeline::collect() {
+
+  uint64_t value = getCompletedValue();
+
+  while (!retired.empty() && retired.begin()->first <= value) {
+    retired.begin()->second();
+    retired.erase(retired.begin());
+  }
+}
+
+vk::Semaphore Timeline::getSemaphore() const {
+  return semaphore;
+}
+
+} //namespace benpu
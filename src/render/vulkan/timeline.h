@@ -0,0 +1,47 @@
+#ifndef BENPU_TIMELINE_H_
+#define BENPU_TIMELINE_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+
+#include <vulkan/vulkan.hpp>
+
+#include "status_code.h"
+
+namespace benpu {
+
+// Monotonic timeline semaphore shared by every submission of a queue. Each
+// submission signals the next value, and CPU waits, cross-queue waits and
+// deferred destruction of resources are all expressed against that counter.
+class Timeline {
+public:
+  Timeline(vk::Device& device);
+
+  StatusCode initialize();
+
+  uint64_t nextSignalValue() const;
+  void markSubmitted(uint64_t value);
+
+  uint64_t getLastSubmittedValue() const;
+  uint64_t getCompletedValue();
+  bool isComplete(uint64_t value);
+  StatusCode wait(uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max());
+
+  void retire(uint64_t value, std::function<void()> destroy);
+  void collect();
+
+  vk::Semaphore getSemaphore() const;
+
+private:
+  vk::Device& device;
+  vk::Semaphore semaphore = nullptr;
+  uint64_t lastSubmittedValue = 0;
+  uint64_t completedValue = 0;
+  std::multimap<uint64_t, std::function<void()>> retired;
+};
+
+} //namespace benpu
+
+#endif
@@ -0,0 +1,159 @@
+
+#include <algorithm>
+#include <cstring>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/uniform_ring.h"
+
+namespace benpu {
+
+// Push constants guarantee 128 bytes, anything above would make the layout
+// differ between devices.
+static constexpr uint32_t maxPushConstantSize = 128;
+static constexpr vk::DeviceSize maxUniformRange = 65536;
+
+UniformRing::UniformRing(vk::Device& device, MemoryAllocator& memoryAllocator, DescriptorAllocator& descriptorAllocator):
+  device{device}, memoryAllocator{memoryAllocator}, descriptorAllocator{descriptorAllocator} {
+
+}
+
+StatusCode UniformRing::initialize(vk::PhysicalDevice physicalDevice, uint32_t framesInFlight, vk::DeviceSize frameSize) {
+
+  vk::PhysicalDeviceLimits limits = physicalDevice.getProperties().limits;
+
+  alignment = limits.minUniformBufferOffsetAlignment;
+  range = std::min<vk::DeviceSize>(limits.maxUniformBufferRange, maxUniformRange);
+  pushConstantSize = std::min(limits.maxPushConstantsSize, maxPushConstantSize);
+  this->frameSize = (frameSize + alignment - 1) / alignment * alignment;
+
+  BOOST_LOG_TRIVIAL(info) << "Creating uniform ring with " << this->frameSize << " bytes per frame.";
+
+  // The descriptor covers a fixed range from the dynamic offset, the tail
+  // keeps the last allocation's range inside the buffer.
+  if (memoryAllocator.createBuffer(
+      this->frameSize * framesInFlight + range,
+      vk::BufferUsageFlagBits::eUniformBuffer,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      buffer,
+      memory
+    ) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create uniform ring buffer.";
+    return StatusCode::bufferCreationError;
+  }
+
+  vk::DescriptorSetLayoutBinding binding(
+    0,
+    vk::DescriptorType::eUniformBufferDynamic,
+    1,
+    vk::ShaderStageFlagBits::eAll
+  );
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo(
+    {},
+    binding
+  );
+
+  try {
+
+    layout = device.createDescriptorSetLayout(layoutInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while uniform ring descriptor creation: " << e.what();
+    return StatusCode::descriptorCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode UniformRing::beginFrame(uint32_t frameIndex) {
+
+  frameStart = frameSize * frameIndex;
+  frameHead = 0;
+
+  // The allocator reset the frame's pools, so the set from the last time
+  // this frame index came around is gone.
+  if (descriptorAllocator.allocate(layout, descriptorSet) != StatusCode::success) {
+    return StatusCode::descriptorCreationError;
+  }
+
+  vk::DescriptorBufferInfo bufferInfo(buffer, 0, range);
+
+  vk::WriteDescriptorSet write(
+    descriptorSet,
+    0,
+    0,
+    1,
+    vk::DescriptorType::eUniformBufferDynamic,
+    nullptr,
+    &bufferInfo
+  );
+
+  device.updateDescriptorSets(write, {});
+
+  return StatusCode::success;
+}
+
+StatusCode UniformRing::allocate(vk::DeviceSize size, Allocation& allocation) {
+
+  if (size > range) {
+    BOOST_LOG_TRIVIAL(error) << "Uniform allocation of " << size << " bytes exceeds the descriptor range.";
+    return StatusCode::memoryAllocationError;
+  }
+
+  // Recording threads allocate concurrently, a single atomic bump keeps
+  // their slices apart.
+  vk::DeviceSize alignedSize = (size + alignment - 1) / alignment * alignment;
+  vk::DeviceSize offset = frameHead.fetch_add(alignedSize);
+
+  if (offset + alignedSize > frameSize) {
+    BOOST_LOG_TRIVIAL(error) << "Uniform ring frame slice of " << frameSize << " bytes is full.";
+    return StatusCode::memoryAllocationError;
+  }
+
+  allocation.offset = static_cast<uint32_t>(frameStart + offset);
+  allocation.data = static_cast<uint8_t*>(memory.mapped) + frameStart + offset;
+
+  return StatusCode::success;
+}
+
+StatusCode UniformRing::setConstants(
+  vk::CommandBuffer commandBuffer,
+  vk::PipelineBindPoint bindPoint,
+  vk::PipelineLayout pipelineLayout,
+  uint32_t set,
+  const void* data,
+  uint32_t size
+) {
+
+  if (size <= pushConstantSize) {
+    commandBuffer.pushConstants(pipelineLayout, vk::ShaderStageFlagBits::eAll, 0, size, data);
+    return StatusCode::success;
+  }
+
+  Allocation allocation;
+
+  if (allocate(size, allocation) != StatusCode::success) {
+    return StatusCode::memoryAllocationError;
+  }
+
+  std::memcpy(allocation.data, data, size);
+
+  commandBuffer.bindDescriptorSets(bindPoint, pipelineLayout, set, descriptorSet, allocation.offset);
+
+  return StatusCode::success;
+}
+
+vk::DescriptorSetLayout UniformRing::getLayout() const {
+  return layout;
+}
+
+vk::PushConstantRange UniformRing::getPushConstantRange() const {
+  return vk::PushConstantRange(vk::ShaderStageFlagBits::eAll, 0, pushConstantSize);
+}
+
+uint32_t UniformRing::getPushConstantSize() const {
+  return pushConstantSize;
+}
+
+} //namespace benpu
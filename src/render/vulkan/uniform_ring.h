@@ -0,0 +1,68 @@
+#ifndef BENPU_UNIFORM_RING_H_
+#define BENPU_UNIFORM_RING_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include <vulkan/vulkan.hpp>
+
+#include "render/vulkan/descriptor_allocator.h"
+#include "render/vulkan/memory_allocator.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Per frame and per draw shader constants. Small payloads go straight into
+// push constants, larger ones are bump-allocated from a persistently mapped
+// buffer sliced per frame in flight and reached through a single dynamic
+// uniform descriptor, so no constant ever needs its own buffer or
+// descriptor write. The descriptor set is taken from the descriptor
+// allocator at the start of every frame and only lives as long as it.
+// Shaders declare a payload as a push_constant block when it fits
+// getPushConstantSize() and as the set's dynamic uniform otherwise.
+class UniformRing {
+public:
+  struct Allocation {
+    uint32_t offset = 0;
+    void* data = nullptr;
+  };
+
+  UniformRing(vk::Device& device, MemoryAllocator& memoryAllocator, DescriptorAllocator& descriptorAllocator);
+
+  StatusCode initialize(vk::PhysicalDevice physicalDevice, uint32_t framesInFlight, vk::DeviceSize frameSize);
+
+  StatusCode beginFrame(uint32_t frameIndex);
+  StatusCode allocate(vk::DeviceSize size, Allocation& allocation);
+
+  StatusCode setConstants(
+    vk::CommandBuffer commandBuffer,
+    vk::PipelineBindPoint bindPoint,
+    vk::PipelineLayout pipelineLayout,
+    uint32_t set,
+    const void* data,
+    uint32_t size
+  );
+
+  vk::DescriptorSetLayout getLayout() const;
+  vk::PushConstantRange getPushConstantRange() const;
+  uint32_t getPushConstantSize() const;
+
+private:
+  vk::Device& device;
+  MemoryAllocator& memoryAllocator;
+  DescriptorAllocator& descriptorAllocator;
+  vk::Buffer buffer = nullptr;
+  MemoryAllocation memory;
+  vk::DescriptorSetLayout layout = nullptr;
+  vk::DescriptorSet descriptorSet = nullptr;
+  vk::DeviceSize frameSize = 0;
+  vk::DeviceSize alignment = 256;
+  vk::DeviceSize range = 0;
+  uint32_t pushConstantSize = 0;
+  vk::DeviceSize frameStart = 0;
+  std::atomic<vk::DeviceSize> frameHead{0};
+};
+
+} //namespace benpu
+
+#endif
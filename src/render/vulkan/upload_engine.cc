@@ -0,0 +1,334 @@
+
+#include <algorithm>
+#include <cstring>
+
+#include <boost/log/trivial.hpp>
+
+#include "render/vulkan/upload_engine.h"
+
+namespace benpu {
+
+UploadEngine::UploadEngine(vk::Device& device, MemoryAllocator& memoryAllocator): device{device}, queue(device), timeline(device), stagingRing(device, memoryAllocator) {
+
+}
+
+StatusCode UploadEngine::initialize(vk::PhysicalDevice physicalDevice, uint32_t transferFamily, uint32_t graphicsFamily, vk::DeviceSize stagingCapacity) {
+
+  BOOST_LOG_TRIVIAL(info) << "Creating upload engine on queue family " << transferFamily << ".";
+
+  this->physicalDevice = physicalDevice;
+  this->transferFamily = transferFamily;
+  this->graphicsFamily = graphicsFamily;
+
+  if (queue.initialize(transferFamily) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create transfer queue.";
+    return StatusCode::queueCreationError;
+  }
+
+  if (timeline.initialize() != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create upload timeline.";
+    return StatusCode::semaphoreCreationError;
+  }
+
+  if (stagingRing.initialize(stagingCapacity) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't create staging ring.";
+    return StatusCode::memoryAllocationError;
+  }
+
+  // Image copies need texel aligned source offsets, 16 covers every format.
+  copyAlignment = std::max<vk::DeviceSize>(16, physicalDevice.getProperties().limits.optimalBufferCopyOffsetAlignment);
+
+  vk::CommandPoolCreateInfo poolInfo(
+    {vk::CommandPoolCreateFlagBits::eTransient},
+    transferFamily
+  );
+
+  try {
+
+    commandPool = device.createCommandPool(poolInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while upload command pool creation: " << e.what();
+    return StatusCode::commandPoolCreationError;
+  }
+
+  return StatusCode::success;
+}
+
+StatusCode UploadEngine::uploadBuffer(vk::Buffer buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size) {
+
+  //Nothing to copy, e.g. a mesh without indices.
+  if (size == 0) {
+    return StatusCode::success;
+  }
+
+  StagingRing::Allocation staging;
+
+  if (stage(data, size, staging) != StatusCode::success) {
+    return StatusCode::memoryAllocationError;
+  }
+
+  bufferUploads.push_back({
+    staging.buffer,
+    buffer,
+    vk::BufferCopy(staging.offset, offset, size)
+  });
+
+  return StatusCode::success;
+}
+
+StatusCode UploadEngine::uploadImage(
+  vk::Image image,
+  vk::Extent3D extent,
+  vk::ImageAspectFlags aspect,
+  const void* data,
+  vk::DeviceSize size,
+  vk::ImageLayout finalLayout
+) {
+
+  StagingRing::Allocation staging;
+
+  if (stage(data, size, staging) != StatusCode::success) {
+    return StatusCode::memoryAllocationError;
+  }
+
+  vk::BufferImageCopy region(
+    staging.offset,
+    0,
+    0,
+    vk::ImageSubresourceLayers(aspect, 0, 0, 1),
+    vk::Offset3D(0, 0, 0),
+    extent
+  );
+
+  imageUploads.push_back({
+    staging.buffer,
+    image,
+    region,
+    vk::ImageSubresourceRange(aspect, 0, 1, 0, 1),
+    finalLayout
+  });
+
+  return StatusCode::success;
+}
+
+StatusCode UploadEngine::flush() {
+
+  if (bufferUploads.empty() && imageUploads.empty()) {
+    return StatusCode::success;
+  }
+
+  uint64_t signalValue = timeline.nextSignalValue();
+  vk::CommandBuffer commandBuffer;
+
+  try {
+
+    vk::CommandBufferAllocateInfo allocInfo(
+      commandPool,
+      vk::CommandBufferLevel::ePrimary,
+      1
+    );
+
+    commandBuffer = device.allocateCommandBuffers(allocInfo).front();
+
+    commandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    recordCopies(commandBuffer);
+    commandBuffer.end();
+
+    vk::CommandBufferSubmitInfo commandBufferInfo(commandBuffer);
+    vk::SemaphoreSubmitInfo signalInfo(
+      timeline.getSemaphore(),
+      signalValue,
+      vk::PipelineStageFlagBits2::eAllCommands
+    );
+
+    vk::SubmitInfo2 submitInfo(
+      {},
+      {},
+      commandBufferInfo,
+      signalInfo
+    );
+
+    queue.getQueue().submit2(submitInfo);
+
+  } catch (vk::SystemError& e) {
+    BOOST_LOG_TRIVIAL(error) << "Vulkan error ocurred while upload submission: " << e.what();
+    return StatusCode::queueSubmitError;
+  }
+
+  timeline.markSubmitted(signalValue);
+  graphicsWaitValue = signalValue;
+
+  // Staging space and the command buffer are given back once the copies
+  // have completed on the transfer queue.
+  stagingRing.retire(signalValue);
+
+  vk::Device retiringDevice = device;
+  vk::CommandPool pool = commandPool;
+
+  timeline.retire(signalValue, [retiringDevice, pool, commandBuffer]() {
+    retiringDevice.freeCommandBuffers(pool, commandBuffer);
+  });
+
+  bufferUploads.clear();
+  imageUploads.clear();
+
+  return StatusCode::success;
+}
+
+void UploadEngine::collect() {
+  timeline.collect();
+  stagingRing.reclaim(timeline.getCompletedValue());
+}
+
+uint64_t UploadEngine::takeGraphicsWaitValue() {
+  uint64_t value = graphicsWaitValue;
+  graphicsWaitValue = 0;
+  return value;
+}
+
+void UploadEngine::recordAcquireBarriers(vk::CommandBuffer commandBuffer) {
+
+  if (acquireImageBarriers.empty() && acquireBufferBarriers.empty()) {
+    return;
+  }
+
+  vk::DependencyInfo dependencyInfo;
+  dependencyInfo.setImageMemoryBarriers(acquireImageBarriers);
+  dependencyInfo.setBufferMemoryBarriers(acquireBufferBarriers);
+
+  commandBuffer.pipelineBarrier2(dependencyInfo);
+
+  acquireImageBarriers.clear();
+  acquireBufferBarriers.clear();
+}
+
+Timeline& UploadEngine::getTimeline() {
+  return timeline;
+}
+
+StatusCode UploadEngine::stage(const void* data, vk::DeviceSize size, StagingRing::Allocation& allocation) {
+
+  if (stagingRing.allocate(size, copyAlignment, allocation) != StatusCode::success) {
+    BOOST_LOG_TRIVIAL(error) << "Couldn't allocate " << size << " bytes of staging memory.";
+    return StatusCode::memoryAllocationError;
+  }
+
+  std::memcpy(allocation.data, data, static_cast<size_t>(size));
+
+  return StatusCode::success;
+}
+
+void UploadEngine::recordCopies(vk::CommandBuffer commandBuffer) {
+
+  // Resources uploaded from a dedicated transfer family change owner, the
+  // release half is recorded here and the acquire half by the graphics
+  // queue.
+  bool transferOwnership = transferFamily != graphicsFamily;
+  uint32_t srcFamily = transferOwnership ? transferFamily : VK_QUEUE_FAMILY_IGNORED;
+  uint32_t dstFamily = transferOwnership ? graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+
+  std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+
+  for (const ImageUpload& upload : imageUploads) {
+    imageBarriers.emplace_back(
+      vk::PipelineStageFlagBits2::eNone,
+      vk::AccessFlagBits2::eNone,
+      vk::PipelineStageFlagBits2::eTransfer,
+      vk::AccessFlagBits2::eTransferWrite,
+      vk::ImageLayout::eUndefined,
+      vk::ImageLayout::eTransferDstOptimal,
+      VK_QUEUE_FAMILY_IGNORED,
+      VK_QUEUE_FAMILY_IGNORED,
+      upload.destination,
+      upload.range
+    );
+  }
+
+  if (!imageBarriers.empty()) {
+    vk::DependencyInfo dependencyInfo;
+    dependencyInfo.setImageMemoryBarriers(imageBarriers);
+    commandBuffer.pipelineBarrier2(dependencyInfo);
+  }
+
+  for (const BufferUpload& upload : bufferUploads) {
+    commandBuffer.copyBuffer(upload.source, upload.destination, upload.region);
+  }
+
+  for (const ImageUpload& upload : imageUploads) {
+    commandBuffer.copyBufferToImage(upload.source, upload.destination, vk::ImageLayout::eTransferDstOptimal, upload.region);
+  }
+
+  imageBarriers.clear();
+  std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+
+  for (const ImageUpload& upload : imageUploads) {
+    imageBarriers.emplace_back(
+      vk::PipelineStageFlagBits2::eTransfer,
+      vk::AccessFlagBits2::eTransferWrite,
+      vk::PipelineStageFlagBits2::eNone,
+      vk::AccessFlagBits2::eNone,
+      vk::ImageLayout::eTransferDstOptimal,
+      upload.finalLayout,
+      srcFamily,
+      dstFamily,
+      upload.destination,
+      upload.range
+    );
+
+    if (transferOwnership) {
+      acquireImageBarriers.emplace_back(
+        vk::PipelineStageFlagBits2::eNone,
+        vk::AccessFlagBits2::eNone,
+        vk::PipelineStageFlagBits2::eAllCommands,
+        vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+        vk::ImageLayout::eTransferDstOptimal,
+        upload.finalLayout,
+        srcFamily,
+        dstFamily,
+        upload.destination,
+        upload.range
+      );
+    }
+  }
+
+  // Within a single family the semaphore wait of the graphics queue already
+  // makes the copied buffers visible.
+  if (transferOwnership) {
+    for (const BufferUpload& upload : bufferUploads) {
+      bufferBarriers.emplace_back(
+        vk::PipelineStageFlagBits2::eTransfer,
+        vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eNone,
+        vk::AccessFlagBits2::eNone,
+        srcFamily,
+        dstFamily,
+        upload.destination,
+        upload.region.dstOffset,
+        upload.region.size
+      );
+
+      acquireBufferBarriers.emplace_back(
+        vk::PipelineStageFlagBits2::eNone,
+        vk::AccessFlagBits2::eNone,
+        vk::PipelineStageFlagBits2::eAllCommands,
+        vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+        srcFamily,
+        dstFamily,
+        upload.destination,
+        upload.region.dstOffset,
+        upload.region.size
+      );
+    }
+  }
+
+  if (!imageBarriers.empty() || !bufferBarriers.empty()) {
+    vk::DependencyInfo dependencyInfo;
+    dependencyInfo.setImageMemoryBarriers(imageBarriers);
+    dependencyInfo.setBufferMemoryBarriers(bufferBarriers);
+    commandBuffer.pipelineBarrier2(dependencyInfo);
+  }
+}
+
+} //namespace benpu
+
@@ -0,0 +1,84 @@
+#ifndef BENPU_UPLOAD_ENGINE_H_
+#define BENPU_UPLOAD_ENGINE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "render/vulkan/memory_allocator.h"
+#include "render/vulkan/queue.h"
+#include "render/vulkan/staging_ring.h"
+#include "render/vulkan/timeline.h"
+#include "status_code.h"
+
+namespace benpu {
+
+// Batches buffer and image uploads onto the transfer queue. Every flush is
+// one submission signalling the upload timeline, the next graphics
+// submission waits on that value and acquires ownership of the uploaded
+// resources, so uploads never block the graphics queue or the CPU.
+class UploadEngine {
+public:
+  UploadEngine(vk::Device& device, MemoryAllocator& memoryAllocator);
+
+  StatusCode initialize(vk::PhysicalDevice physicalDevice, uint32_t transferFamily, uint32_t graphicsFamily, vk::DeviceSize stagingCapacity);
+
+  StatusCode uploadBuffer(vk::Buffer buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size);
+  StatusCode uploadImage(
+    vk::Image image,
+    vk::Extent3D extent,
+    vk::ImageAspectFlags aspect,
+    const void* data,
+    vk::DeviceSize size,
+    vk::ImageLayout finalLayout
+  );
+
+  StatusCode flush();
+  void collect();
+
+  uint64_t takeGraphicsWaitValue();
+  void recordAcquireBarriers(vk::CommandBuffer commandBuffer);
+
+  Timeline& getTimeline();
+
+private:
+  struct BufferUpload {
+    vk::Buffer source;
+    vk::Buffer destination;
+    vk::BufferCopy region;
+  };
+
+  struct ImageUpload {
+    vk::Buffer source;
+    vk::Image destination;
+    vk::BufferImageCopy region;
+    vk::ImageSubresourceRange range;
+    vk::ImageLayout finalLayout;
+  };
+
+  vk::Device& device;
+  vk::PhysicalDevice physicalDevice = nullptr;
+  uint32_t transferFamily = 0;
+  uint32_t graphicsFamily = 0;
+  Queue queue;
+  Timeline timeline;
+  vk::CommandPool commandPool = nullptr;
+  StagingRing stagingRing;
+  vk::DeviceSize copyAlignment = 16;
+
+  std::vector<BufferUpload> bufferUploads;
+  std::vector<ImageUpload> imageUploads;
+
+  std::vector<vk::ImageMemoryBarrier2> acquireImageBarriers;
+  std::vector<vk::BufferMemoryBarrier2> acquireBufferBarriers;
+  uint64_t graphicsWaitValue = 0;
+
+private:
+  StatusCode stage(const void* data, vk::DeviceSize size, StagingRing::Allocation& allocation);
+  void recordCopies(vk::CommandBuffer commandBuffer);
+};
+
+} //namespace benpu
+
+#endif
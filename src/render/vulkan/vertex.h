@@ -0,0 +1,36 @@
+#ifndef BENPU_VERTEX_H_
+#define BENPU_VERTEX_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace benpu {
+
+struct VertexLayout {
+  std::vector<vk::VertexInputBindingDescription> bindings;
+  std::vector<vk::VertexInputAttributeDescription> attributes;
+};
+
+struct Vertex {
+  glm::vec2 position;
+  glm::vec3 color;
+
+  static VertexLayout getLayout() {
+    return {
+      {
+        vk::VertexInputBindingDescription(0, sizeof(Vertex), vk::VertexInputRate::eVertex)
+      },
+      {
+        vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32Sfloat, offsetof(Vertex, position)),
+        vk::VertexInputAttributeDescription(1, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color))
+      }
+    };
+  }
+};
+
+} //namespace benpu
+
+#endif
@@ -11,10 +11,13 @@ namespace benpu {
     
     vkfw::WindowHints hints;
     hints.clientAPI = vkfw::ClientAPI::eNone;
-    //for now it won't be resizable
-    hints.resizable = false;
+    hints.resizable = true;
 
     window = vkfw::createWindow(width, height, "Benpu", hints);
+
+    window.callbacks()->on_framebuffer_resize = [this](const vkfw::Window&, size_t, size_t) {
+      resized = true;
+    };
   }
 
   Window::~Window() {
@@ -40,6 +43,12 @@ namespace benpu {
     return window.getFramebufferSize();
   }
 
+  bool Window::checkResized() {
+    bool wasResized = resized;
+    resized = false;
+    return wasResized;
+  }
+
   vk::SurfaceKHR Window::createSurface(vk::Instance& instance) {
     return vkfw::createWindowSurface(instance, window);
   }
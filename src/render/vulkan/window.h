@@ -20,12 +20,14 @@ public:
   void pollEvents() { vkfw::pollEvents(); }
   vk::SurfaceKHR createSurface(vk::Instance& instance);
   std::tuple<int, int> getFramebufferSize() const;
+  bool checkResized();
 
   static std::vector<const char*> getRequiredVulkanExtensions();
   
 private:
   uint32_t width;
   uint32_t height;
+  bool resized = false;
   vkfw::Window window;
   
 };
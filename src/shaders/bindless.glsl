@@ -0,0 +1,16 @@
+// Declarations of the global bindless table, see BindlessTable. Resources
+// are indexed with nonuniformEXT() when the index isn't dynamically uniform,
+// the device is required to support it for all three tables:
+// shaderStorageBufferArrayNonUniformIndexing for storageBuffers[] and
+// shaderSampledImageArrayNonUniformIndexing for samplers[] and
+// sampledImages[].
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 0, binding = 0) buffer StorageBuffers {
+    uint words[];
+} storageBuffers[];
+
+layout(set = 0, binding = 1) uniform sampler samplers[];
+
+layout(set = 0, binding = 2) uniform texture2D sampledImages[];
@@ -22,7 +22,16 @@ enum StatusCode: int {
     semaphoreCreationError,
     fenceCreationError,
     extensionNotPresent,
-    queueCreationError
+    queueCreationError,
+    semaphoreWaitError,
+    renderGraphCompilationError,
+    queueSubmitError,
+    bufferCreationError,
+    memoryAllocationError,
+    imageCreationError,
+    descriptorCreationError,
+    pipelineCacheError,
+    shaderWatchError
 };
 
 enum ObjectStatus {
@@ -63,4 +63,23 @@ BOOST_AUTO_TEST_CASE( test_execution_with_incorrect_arg_2 ) {
 
   BOOST_CHECK_MESSAGE( !args.isCorrect(), "The argumens should be incorrect." );
 
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE( test_headless_execution ) {
+
+  char c[] = "-c"; 
+  char config[] = "config.json";
+  char h[] = "-H"; 
+  char* argv[] = {
+    executable,
+    c,
+    config,
+    h
+  };
+
+  benpu::Args args(4, argv);
+
+  BOOST_CHECK( args.isCorrect() );
+  BOOST_CHECK_EQUAL( args.getValue(benpu::ArgType::headless), "true" );
+
+}
@@ -0,0 +1,60 @@
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "core/utils/buddy_allocator.h"
+
+BOOST_AUTO_TEST_CASE( test_allocations_are_aligned_to_their_block ) {
+
+  benpu::BuddyAllocator buddy(1024, 64);
+
+  uint64_t first = buddy.allocate(10, 1).value();
+  uint64_t second = buddy.allocate(100, 1).value();
+  uint64_t third = buddy.allocate(16, 256).value();
+
+  BOOST_CHECK_EQUAL( first % 64, 0u );
+  BOOST_CHECK_EQUAL( second % 128, 0u );
+  BOOST_CHECK_EQUAL( third % 256, 0u );
+  BOOST_CHECK_EQUAL( buddy.getAllocatedBytes(), 64u + 128u + 256u );
+  BOOST_CHECK_EQUAL( buddy.getRequestedBytes(), 10u + 100u + 16u );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_freed_blocks_merge_back ) {
+
+  benpu::BuddyAllocator buddy(1024, 64);
+
+  std::vector<uint64_t> offsets;
+  for (int i = 0; i < 16; ++i) {
+    offsets.push_back(buddy.allocate(64, 1).value());
+  }
+
+  BOOST_CHECK( !buddy.allocate(64, 1).has_value() );
+  BOOST_CHECK_EQUAL( buddy.getLargestFreeBlock(), 0u );
+
+  for (uint64_t offset : offsets) {
+    buddy.free(offset);
+  }
+
+  BOOST_CHECK( buddy.isEmpty() );
+  BOOST_CHECK_EQUAL( buddy.getLargestFreeBlock(), 1024u );
+  BOOST_CHECK_EQUAL( buddy.allocate(1024, 1).value(), 0u );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_oversized_allocation_fails ) {
+
+  benpu::BuddyAllocator buddy(1024, 64);
+
+  BOOST_CHECK( !buddy.allocate(2048, 1).has_value() );
+  BOOST_CHECK( !buddy.allocate(16, 2048).has_value() );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_size_rounds_down_to_power_of_two ) {
+
+  benpu::BuddyAllocator buddy(1000, 64);
+
+  BOOST_CHECK_EQUAL( buddy.getSize(), 512u );
+
+}
@@ -0,0 +1,54 @@
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+#include "core/utils/frame_pacer.h"
+
+using Clock = benpu::FramePacer::Clock;
+
+BOOST_AUTO_TEST_CASE( test_disabled_pacer_doesnt_wait ) {
+
+  benpu::FramePacer pacer(0.0);
+
+  BOOST_CHECK( !pacer.isEnabled() );
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < 100; ++i) {
+    pacer.wait();
+  }
+
+  BOOST_CHECK( Clock::now() - start < std::chrono::milliseconds(5) );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_pacer_holds_frame_rate ) {
+
+  benpu::FramePacer pacer(200.0);
+
+  BOOST_CHECK( pacer.isEnabled() );
+
+  // The first wait sets the first deadline no earlier than start, the
+  // other 20 are a whole frame apart.
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < 21; ++i) {
+    pacer.wait();
+  }
+
+  BOOST_CHECK( Clock::now() - start >= 20 * pacer.getTargetFrameTime() );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_pacer_doesnt_burst_after_stall ) {
+
+  benpu::FramePacer pacer(200.0);
+
+  pacer.wait();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  Clock::time_point start = Clock::now();
+  pacer.wait();
+  pacer.wait();
+
+  BOOST_CHECK( Clock::now() - start >= pacer.getTargetFrameTime() );
+
+}
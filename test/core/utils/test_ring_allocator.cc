@@ -0,0 +1,75 @@
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include "core/utils/ring_allocator.h"
+
+BOOST_AUTO_TEST_CASE( test_allocations_are_aligned ) {
+
+  benpu::RingAllocator ring(1024);
+
+  BOOST_CHECK_EQUAL( ring.allocate(10, 16).value(), 0u );
+  BOOST_CHECK_EQUAL( ring.allocate(10, 16).value(), 16u );
+  BOOST_CHECK_EQUAL( ring.allocate(4, 256).value(), 256u );
+  BOOST_CHECK_EQUAL( ring.getUsed(), 260u );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_space_is_reclaimed_by_value ) {
+
+  benpu::RingAllocator ring(256);
+
+  BOOST_CHECK( ring.allocate(128, 1).has_value() );
+  ring.retire(1);
+  BOOST_CHECK( ring.allocate(128, 1).has_value() );
+  ring.retire(2);
+
+  BOOST_CHECK( !ring.allocate(1, 1).has_value() );
+
+  ring.reclaim(1);
+  BOOST_CHECK_EQUAL( ring.getUsed(), 128u );
+  BOOST_CHECK_EQUAL( ring.allocate(64, 1).value(), 0u );
+
+  // Only the unretired allocation is left.
+  ring.reclaim(2);
+  BOOST_CHECK_EQUAL( ring.getUsed(), 64u );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_allocation_wraps_around ) {
+
+  benpu::RingAllocator ring(256);
+
+  BOOST_CHECK( ring.allocate(200, 1).has_value() );
+  ring.retire(1);
+  ring.reclaim(1);
+
+  // 56 bytes are left before the end, the allocation restarts at 0.
+  BOOST_CHECK_EQUAL( ring.allocate(100, 1).value(), 0u );
+  BOOST_CHECK_EQUAL( ring.getUsed(), 156u );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_unretired_allocations_are_kept ) {
+
+  benpu::RingAllocator ring(128);
+
+  BOOST_CHECK( ring.allocate(128, 1).has_value() );
+  BOOST_CHECK( ring.hasUnretiredAllocations() );
+
+  ring.reclaim(100);
+  BOOST_CHECK_EQUAL( ring.getUsed(), 128u );
+
+  ring.retire(5);
+  BOOST_CHECK( !ring.hasUnretiredAllocations() );
+  ring.reclaim(5);
+  BOOST_CHECK_EQUAL( ring.getUsed(), 0u );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_oversized_allocation_fails ) {
+
+  benpu::RingAllocator ring(64);
+
+  BOOST_CHECK( !ring.allocate(65, 1).has_value() );
+
+}
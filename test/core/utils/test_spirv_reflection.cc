@@ -0,0 +1,143 @@
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "core/utils/spirv_reflection.h"
+
+namespace {
+
+// Minimal assembler, enough to lay out the instructions reflection reads.
+class Assembler {
+public:
+  Assembler(uint32_t executionModel) {
+    code = {0x07230203, 0x00010000, 0, 100, 0};
+    // OpEntryPoint %1 "main"
+    op(15, {executionModel, 1, 0x6e69616d, 0});
+  }
+
+  void op(uint32_t opcode, std::initializer_list<uint32_t> operands) {
+    code.push_back(static_cast<uint32_t>(operands.size() + 1) << 16 | opcode);
+    code.insert(code.end(), operands);
+  }
+
+  std::vector<uint32_t> code;
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( test_vertex_module_interface ) {
+
+  Assembler assembler(0);
+
+  assembler.op(71, {28, 34, 0});    // %28 DescriptorSet 0
+  assembler.op(71, {28, 33, 1});    // %28 Binding 1
+  assembler.op(71, {35, 34, 1});    // %35 DescriptorSet 1
+  assembler.op(71, {35, 33, 0});    // %35 Binding 0
+  assembler.op(71, {32, 6, 16});    // %32 ArrayStride 16
+  assembler.op(72, {33, 0, 35, 0}); // %33 member 0 Offset 0
+  assembler.op(72, {22, 0, 35, 0}); // %22 member 0 Offset 0
+  assembler.op(71, {41, 30, 1});    // %41 Location 1
+  assembler.op(71, {44, 30, 0});    // %44 Location 0
+  assembler.op(71, {47, 11, 42});   // %47 BuiltIn VertexIndex
+  assembler.op(71, {50, 1, 3});     // %50 SpecId 3
+  assembler.op(71, {51, 1, 1});     // %51 SpecId 1
+
+  assembler.op(22, {20, 32});       // %20 float
+  assembler.op(23, {21, 20, 4});    // %21 vec4
+  assembler.op(30, {22, 21});       // %22 struct { vec4 }
+  assembler.op(32, {23, 9, 22});    // %23 PushConstant pointer
+  assembler.op(59, {23, 24, 9});
+
+  assembler.op(26, {25});           // %25 sampler
+  assembler.op(29, {26, 25});       // %26 sampler[]
+  assembler.op(32, {27, 0, 26});
+  assembler.op(59, {27, 28, 0});
+
+  assembler.op(21, {30, 32, 0});    // %30 uint
+  assembler.op(43, {30, 31, 4});    // %31 4u
+  assembler.op(28, {32, 21, 31});   // %32 vec4[4]
+  assembler.op(30, {33, 32});       // %33 struct { vec4[4] }
+  assembler.op(32, {34, 2, 33});
+  assembler.op(59, {34, 35, 2});
+
+  assembler.op(32, {40, 1, 21});
+  assembler.op(59, {40, 41, 1});    // vec4 at location 1
+  assembler.op(23, {42, 30, 2});    // %42 uvec2
+  assembler.op(32, {43, 1, 42});
+  assembler.op(59, {43, 44, 1});    // uvec2 at location 0
+  assembler.op(21, {45, 32, 1});    // %45 int
+  assembler.op(32, {46, 1, 45});
+  assembler.op(59, {46, 47, 1});    // gl_VertexIndex
+
+  assembler.op(50, {30, 50, 7});
+  assembler.op(50, {30, 51, 0});
+
+  auto reflection = benpu::reflectSpirv(assembler.code.data(), assembler.code.size());
+
+  BOOST_REQUIRE( reflection.has_value() );
+  BOOST_CHECK( reflection->stage == benpu::SpirvReflection::Stage::vertex );
+
+  BOOST_REQUIRE_EQUAL( reflection->bindings.size(), 2u );
+  BOOST_CHECK_EQUAL( reflection->bindings[0].set, 0u );
+  BOOST_CHECK_EQUAL( reflection->bindings[0].binding, 1u );
+  BOOST_CHECK( reflection->bindings[0].kind == benpu::SpirvReflection::DescriptorKind::sampler );
+  BOOST_CHECK_EQUAL( reflection->bindings[0].count, 0u );
+  BOOST_CHECK_EQUAL( reflection->bindings[1].set, 1u );
+  BOOST_CHECK( reflection->bindings[1].kind == benpu::SpirvReflection::DescriptorKind::uniformBuffer );
+  BOOST_CHECK_EQUAL( reflection->bindings[1].count, 1u );
+
+  BOOST_CHECK_EQUAL( reflection->pushConstantOffset, 0u );
+  BOOST_CHECK_EQUAL( reflection->pushConstantSize, 16u );
+
+  BOOST_REQUIRE_EQUAL( reflection->vertexInputs.size(), 2u );
+  BOOST_CHECK_EQUAL( reflection->vertexInputs[0].location, 0u );
+  BOOST_CHECK( reflection->vertexInputs[0].type == benpu::SpirvReflection::ScalarType::uintType );
+  BOOST_CHECK_EQUAL( reflection->vertexInputs[0].components, 2u );
+  BOOST_CHECK_EQUAL( reflection->vertexInputs[1].location, 1u );
+  BOOST_CHECK( reflection->vertexInputs[1].type == benpu::SpirvReflection::ScalarType::floatType );
+  BOOST_CHECK_EQUAL( reflection->vertexInputs[1].width, 32u );
+  BOOST_CHECK_EQUAL( reflection->vertexInputs[1].components, 4u );
+
+  BOOST_CHECK( (reflection->specializationIds == std::vector<uint32_t>{1, 3}) );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_push_constant_range_starts_at_first_member ) {
+
+  Assembler assembler(4);
+
+  assembler.op(72, {22, 0, 35, 64}); // member 0 Offset 64
+  assembler.op(72, {22, 1, 35, 80}); // member 1 Offset 80
+  assembler.op(22, {20, 32});
+  assembler.op(23, {21, 20, 4});
+  assembler.op(30, {22, 21, 20});    // struct { vec4, float }
+  assembler.op(32, {23, 9, 22});
+  assembler.op(59, {23, 24, 9});
+
+  auto reflection = benpu::reflectSpirv(assembler.code.data(), assembler.code.size());
+
+  BOOST_REQUIRE( reflection.has_value() );
+  BOOST_CHECK( reflection->stage == benpu::SpirvReflection::Stage::fragment );
+  BOOST_CHECK_EQUAL( reflection->pushConstantOffset, 64u );
+  BOOST_CHECK_EQUAL( reflection->pushConstantSize, 20u );
+  BOOST_CHECK( reflection->vertexInputs.empty() );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_malformed_modules_are_rejected ) {
+
+  Assembler assembler(0);
+
+  std::vector<uint32_t> badMagic = assembler.code;
+  badMagic[0] = 0;
+  BOOST_CHECK( !benpu::reflectSpirv(badMagic.data(), badMagic.size()).has_value() );
+
+  std::vector<uint32_t> truncated = assembler.code;
+  truncated.pop_back();
+  BOOST_CHECK( !benpu::reflectSpirv(truncated.data(), truncated.size()).has_value() );
+
+  BOOST_CHECK( !benpu::reflectSpirv(assembler.code.data(), 4).has_value() );
+
+}
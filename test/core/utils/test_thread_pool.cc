@@ -0,0 +1,56 @@
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <future>
+#include <vector>
+
+#include "core/utils/thread_pool.h"
+
+BOOST_AUTO_TEST_CASE( test_dispatch_runs_every_task ) {
+
+  benpu::ThreadPool pool(4);
+
+  std::vector<int> results(1000, 0);
+
+  pool.dispatch(static_cast<uint32_t>(results.size()), [&results](uint32_t task, uint32_t worker) {
+    results[task] = static_cast<int>(task) * 2;
+  });
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    BOOST_CHECK_EQUAL( results[i], static_cast<int>(i) * 2 );
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE( test_worker_index_is_in_range ) {
+
+  benpu::ThreadPool pool(3);
+
+  BOOST_CHECK_EQUAL( pool.getThreadCount(), 3u );
+
+  std::atomic<bool> outOfRange{false};
+
+  pool.dispatch(100, [&outOfRange, &pool](uint32_t task, uint32_t worker) {
+    if (worker >= pool.getThreadCount()) {
+      outOfRange = true;
+    }
+  });
+
+  BOOST_CHECK( !outOfRange );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_submit_runs_job ) {
+
+  benpu::ThreadPool pool(2);
+
+  std::promise<int> promise;
+  std::future<int> future = promise.get_future();
+
+  pool.submit([&promise](uint32_t worker) {
+    promise.set_value(42);
+  });
+
+  BOOST_CHECK_EQUAL( future.get(), 42 );
+
+}
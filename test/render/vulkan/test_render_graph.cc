@@ -0,0 +1,204 @@
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+
+#include "render/vulkan/render_graph.h"
+
+namespace {
+
+// compile() only looks at the handles, they never reach a device.
+vk::Image fakeImage(uintptr_t value) {
+  return vk::Image(reinterpret_cast<VkImage>(value));
+}
+
+void noop(vk::CommandBuffer) {
+
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( test_unused_pass_is_culled ) {
+
+  benpu::RenderGraph graph;
+
+  auto backbuffer = graph.importImage("backbuffer", fakeImage(1), vk::ImageLayout::eUndefined);
+  auto scratch = graph.importImage("scratch", fakeImage(2), vk::ImageLayout::eUndefined);
+  graph.exportImage(backbuffer, vk::ImageLayout::ePresentSrcKHR);
+
+  graph.addPass("unused", noop).write(scratch, benpu::ResourceUsage::colorAttachment);
+  graph.addPass("draw", noop).write(backbuffer, benpu::ResourceUsage::colorAttachment);
+
+  BOOST_REQUIRE_EQUAL( graph.compile(), StatusCode::success );
+
+  BOOST_CHECK_EQUAL( graph.getCulledPassCount(), 1u );
+  BOOST_REQUIRE_EQUAL( graph.getBatches().size(), 1u );
+  BOOST_REQUIRE_EQUAL( graph.getBatches()[0].passes.size(), 1u );
+  BOOST_CHECK_EQUAL( graph.getBatches()[0].passes[0], 1u );
+  BOOST_CHECK( graph.getPassImageBarriers(0).empty() );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_write_then_read_is_one_transition ) {
+
+  benpu::RenderGraph graph;
+
+  auto image = graph.importImage("image", fakeImage(1), vk::ImageLayout::eUndefined);
+
+  graph.addPass("write", noop).write(image, benpu::ResourceUsage::colorAttachment);
+  graph.addPass("read", noop).read(image, benpu::ResourceUsage::shaderRead).keepAlive();
+
+  BOOST_REQUIRE_EQUAL( graph.compile(), StatusCode::success );
+
+  const auto& barriers = graph.getPassImageBarriers(1);
+
+  BOOST_REQUIRE_EQUAL( barriers.size(), 1u );
+  BOOST_CHECK( barriers[0].srcStageMask == vk::PipelineStageFlagBits2::eColorAttachmentOutput );
+  BOOST_CHECK( barriers[0].srcAccessMask == (vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eColorAttachmentRead) );
+  BOOST_CHECK( barriers[0].dstStageMask == (vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eFragmentShader
+    | vk::PipelineStageFlagBits2::eComputeShader) );
+  BOOST_CHECK( barriers[0].dstAccessMask == vk::AccessFlagBits2::eShaderSampledRead );
+  BOOST_CHECK( barriers[0].oldLayout == vk::ImageLayout::eColorAttachmentOptimal );
+  BOOST_CHECK( barriers[0].newLayout == vk::ImageLayout::eShaderReadOnlyOptimal );
+  BOOST_CHECK_EQUAL( barriers[0].srcQueueFamilyIndex, VK_QUEUE_FAMILY_IGNORED );
+  BOOST_CHECK_EQUAL( barriers[0].dstQueueFamilyIndex, VK_QUEUE_FAMILY_IGNORED );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_read_after_read_needs_no_barrier ) {
+
+  benpu::RenderGraph graph;
+
+  auto image = graph.importImage("image", fakeImage(1), vk::ImageLayout::eUndefined);
+
+  graph.addPass("write", noop).write(image, benpu::ResourceUsage::colorAttachment);
+  graph.addPass("first read", noop).read(image, benpu::ResourceUsage::shaderRead).keepAlive();
+  graph.addPass("second read", noop).read(image, benpu::ResourceUsage::shaderRead).keepAlive();
+
+  BOOST_REQUIRE_EQUAL( graph.compile(), StatusCode::success );
+
+  BOOST_CHECK_EQUAL( graph.getPassImageBarriers(1).size(), 1u );
+  BOOST_CHECK( graph.getPassImageBarriers(2).empty() );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_export_transitions_to_final_layout ) {
+
+  benpu::RenderGraph graph;
+
+  auto backbuffer = graph.importImage("backbuffer", fakeImage(1), vk::ImageLayout::eUndefined);
+  graph.exportImage(backbuffer, vk::ImageLayout::ePresentSrcKHR);
+
+  graph.addPass("draw", noop).write(backbuffer, benpu::ResourceUsage::colorAttachment);
+
+  BOOST_REQUIRE_EQUAL( graph.compile(), StatusCode::success );
+
+  const auto& barriers = graph.getFinalImageBarriers();
+
+  BOOST_REQUIRE_EQUAL( barriers.size(), 1u );
+  BOOST_CHECK( barriers[0].srcStageMask == vk::PipelineStageFlagBits2::eColorAttachmentOutput );
+  BOOST_CHECK( barriers[0].srcAccessMask == (vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eColorAttachmentRead) );
+  BOOST_CHECK( barriers[0].dstStageMask == vk::PipelineStageFlagBits2::eNone );
+  BOOST_CHECK( barriers[0].oldLayout == vk::ImageLayout::eColorAttachmentOptimal );
+  BOOST_CHECK( barriers[0].newLayout == vk::ImageLayout::ePresentSrcKHR );
+
+}
+
+BOOST_AUTO_TEST_CASE( test_compute_pass_transfers_ownership ) {
+
+  const uint32_t graphicsFamily = 0;
+  const uint32_t computeFamily = 1;
+  const vk::PipelineStageFlags2 uniformStages = vk::PipelineStageFlagBits2::eVertexShader
+    | vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader;
+
+  benpu::RenderGraph graph;
+  graph.setQueueFamilies(graphicsFamily, computeFamily);
+
+  auto scene = graph.importImage("scene", fakeImage(1), vk::ImageLayout::eUndefined);
+  auto backbuffer = graph.importImage("backbuffer", fakeImage(2), vk::ImageLayout::eUndefined);
+  auto histogram = graph.importBuffer("histogram", vk::Buffer(reinterpret_cast<VkBuffer>(uintptr_t(3))));
+  graph.exportImage(backbuffer, vk::ImageLayout::ePresentSrcKHR);
+
+  graph.addPass("scene", noop)
+    .write(scene, benpu::ResourceUsage::colorAttachment);
+  graph.addPass("histogram", noop, benpu::QueueType::compute)
+    .read(scene, benpu::ResourceUsage::storage)
+    .write(histogram, benpu::ResourceUsage::storage);
+  graph.addPass("tonemap", noop)
+    .read(histogram, benpu::ResourceUsage::uniform)
+    .write(backbuffer, benpu::ResourceUsage::colorAttachment);
+
+  BOOST_REQUIRE_EQUAL( graph.compile(), StatusCode::success );
+
+  // Graphics, compute, graphics, one pass each.
+  const auto& batches = graph.getBatches();
+
+  BOOST_REQUIRE_EQUAL( batches.size(), 3u );
+  BOOST_CHECK( batches[0].queue == benpu::QueueType::graphics );
+  BOOST_CHECK( batches[1].queue == benpu::QueueType::compute );
+  BOOST_CHECK( batches[2].queue == benpu::QueueType::graphics );
+  for (uint32_t i = 0; i < 3; ++i) {
+    BOOST_REQUIRE_EQUAL( batches[i].passes.size(), 1u );
+    BOOST_CHECK_EQUAL( batches[i].passes[0], i );
+  }
+
+  BOOST_CHECK( batches[0].waits.empty() );
+  BOOST_REQUIRE_EQUAL( batches[1].waits.size(), 1u );
+  BOOST_CHECK_EQUAL( batches[1].waits[0].batch, 0u );
+  BOOST_CHECK( batches[1].waits[0].stages == vk::PipelineStageFlagBits2::eComputeShader );
+  BOOST_REQUIRE_EQUAL( batches[2].waits.size(), 1u );
+  BOOST_CHECK_EQUAL( batches[2].waits[0].batch, 1u );
+  BOOST_CHECK( (batches[2].waits[0].stages & uniformStages) == uniformStages );
+
+  // Scene image, graphics to compute.
+  BOOST_REQUIRE_EQUAL( batches[0].releaseImageBarriers.size(), 1u );
+  const auto& sceneRelease = batches[0].releaseImageBarriers[0];
+  BOOST_CHECK_EQUAL( sceneRelease.srcQueueFamilyIndex, graphicsFamily );
+  BOOST_CHECK_EQUAL( sceneRelease.dstQueueFamilyIndex, computeFamily );
+  BOOST_CHECK( sceneRelease.srcStageMask == vk::PipelineStageFlagBits2::eColorAttachmentOutput );
+  BOOST_CHECK( sceneRelease.dstStageMask == vk::PipelineStageFlagBits2::eNone );
+  BOOST_CHECK( sceneRelease.oldLayout == vk::ImageLayout::eColorAttachmentOptimal );
+  BOOST_CHECK( sceneRelease.newLayout == vk::ImageLayout::eGeneral );
+
+  BOOST_REQUIRE_EQUAL( graph.getPassImageBarriers(1).size(), 1u );
+  const auto& sceneAcquire = graph.getPassImageBarriers(1)[0];
+  BOOST_CHECK_EQUAL( sceneAcquire.srcQueueFamilyIndex, graphicsFamily );
+  BOOST_CHECK_EQUAL( sceneAcquire.dstQueueFamilyIndex, computeFamily );
+  BOOST_CHECK( sceneAcquire.srcStageMask == vk::PipelineStageFlagBits2::eNone );
+  BOOST_CHECK( sceneAcquire.dstStageMask == vk::PipelineStageFlagBits2::eComputeShader );
+  BOOST_CHECK( sceneAcquire.dstAccessMask == vk::AccessFlagBits2::eShaderStorageRead );
+  BOOST_CHECK( sceneAcquire.oldLayout == vk::ImageLayout::eColorAttachmentOptimal );
+  BOOST_CHECK( sceneAcquire.newLayout == vk::ImageLayout::eGeneral );
+
+  // Histogram buffer, compute back to graphics.
+  BOOST_REQUIRE_EQUAL( batches[1].releaseBufferBarriers.size(), 1u );
+  const auto& histogramRelease = batches[1].releaseBufferBarriers[0];
+  BOOST_CHECK_EQUAL( histogramRelease.srcQueueFamilyIndex, computeFamily );
+  BOOST_CHECK_EQUAL( histogramRelease.dstQueueFamilyIndex, graphicsFamily );
+  BOOST_CHECK( histogramRelease.srcStageMask == vk::PipelineStageFlagBits2::eComputeShader );
+  BOOST_CHECK( histogramRelease.srcAccessMask == (vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eShaderStorageRead) );
+  BOOST_CHECK( histogramRelease.dstStageMask == vk::PipelineStageFlagBits2::eNone );
+
+  BOOST_REQUIRE_EQUAL( graph.getPassBufferBarriers(2).size(), 1u );
+  const auto& histogramAcquire = graph.getPassBufferBarriers(2)[0];
+  BOOST_CHECK_EQUAL( histogramAcquire.srcQueueFamilyIndex, computeFamily );
+  BOOST_CHECK_EQUAL( histogramAcquire.dstQueueFamilyIndex, graphicsFamily );
+  BOOST_CHECK( histogramAcquire.srcStageMask == vk::PipelineStageFlagBits2::eNone );
+  BOOST_CHECK( histogramAcquire.dstStageMask == uniformStages );
+  BOOST_CHECK( histogramAcquire.dstAccessMask == vk::AccessFlagBits2::eUniformRead );
+
+  // The scene image is still owned by compute at the end, it is handed back
+  // to graphics along with the present transition.
+  BOOST_REQUIRE_EQUAL( batches[1].releaseImageBarriers.size(), 1u );
+  BOOST_CHECK_EQUAL( batches[1].releaseImageBarriers[0].srcQueueFamilyIndex, computeFamily );
+  BOOST_CHECK_EQUAL( batches[1].releaseImageBarriers[0].dstQueueFamilyIndex, graphicsFamily );
+  BOOST_CHECK( batches[1].releaseImageBarriers[0].srcStageMask == vk::PipelineStageFlagBits2::eComputeShader );
+
+  const auto& finalBarriers = graph.getFinalImageBarriers();
+  BOOST_REQUIRE_EQUAL( finalBarriers.size(), 2u );
+  BOOST_CHECK_EQUAL( finalBarriers[0].srcQueueFamilyIndex, computeFamily );
+  BOOST_CHECK_EQUAL( finalBarriers[0].dstQueueFamilyIndex, graphicsFamily );
+  BOOST_CHECK( finalBarriers[0].oldLayout == vk::ImageLayout::eGeneral );
+  BOOST_CHECK( finalBarriers[0].newLayout == vk::ImageLayout::eGeneral );
+  BOOST_CHECK( finalBarriers[1].newLayout == vk::ImageLayout::ePresentSrcKHR );
+
+}